@@ -0,0 +1,153 @@
+#pragma once
+
+#include <utility>
+#include <stdexcept>
+
+#include "dependencies/DynamicArray.h"
+#include "dependencies/HashMap.h"
+
+#include "IPriorityQueue.h"
+
+using namespace dictionary;
+
+//Binary min-heap, that keeps position of every item in a hash map,
+//so priority of a queued item can be decreased in O(log n)
+template<class T>
+class BinaryHeap : public IPriorityQueue<T>
+{
+public:
+	typedef std::pair<int, T> HeapItem;
+private:
+	DynamicArray<HeapItem>* items;
+	IDictionary<T, int>* positions;
+
+	int itemsCount;
+
+	static const int default_size = 64;
+public:
+	BinaryHeap(std::function<int(T, int)> hashFunc, int size = default_size) :
+		items(new DynamicArray<HeapItem>(size)), positions(new HashMap<T, int>(hashFunc)), itemsCount(0)
+	{}
+public:
+	void Push(T item, int priority) override
+	{
+		if (positions->Contains(item))
+			throw std::invalid_argument("Item is already in the queue!");
+
+		if (itemsCount >= items->GetCapacity())
+			items->Resize(items->GetCapacity() * 2);
+
+		Place(std::make_pair(priority, item), itemsCount);
+		itemsCount++;
+
+		SiftUp(itemsCount - 1);
+	}
+	void DecreasePriority(T item, int priority) override
+	{
+		int index = positions->Get(item);
+
+		if (priority > items->Get(index).first)
+			throw std::invalid_argument("Priority can only be decreased!");
+
+		Place(std::make_pair(priority, item), index);
+
+		SiftUp(index);
+	}
+	T PopMin() override
+	{
+		if (itemsCount == 0)
+			throw std::out_of_range("Queue is empty!");
+
+		T res = items->Get(0).second;
+
+		positions->Remove(res);
+		itemsCount--;
+
+		if (itemsCount > 0)
+		{
+			Place(items->Get(itemsCount), 0);
+			SiftDown(0);
+		}
+
+		return res;
+	}
+public:
+	int MinPriority() const override
+	{
+		if (itemsCount == 0)
+			throw std::out_of_range("Queue is empty!");
+
+		return items->Get(0).first;
+	}
+	bool Contains(T item) const override
+	{
+		return positions->Contains(item);
+	}
+	int Count() const override
+	{
+		return itemsCount;
+	}
+	bool IsEmpty() const override
+	{
+		return itemsCount == 0;
+	}
+	void Clear() override
+	{
+		for (int i = 0; i < itemsCount; i++)
+			positions->Remove(items->Get(i).second);
+
+		itemsCount = 0;
+	}
+private:
+	void Place(HeapItem item, int index)
+	{
+		items->Set(item, index);
+		positions->Add(item.second, index);
+	}
+	void SiftUp(int index)
+	{
+		HeapItem item = items->Get(index);
+
+		while (index > 0)
+		{
+			int parent = (index - 1) / 2;
+			HeapItem parentItem = items->Get(parent);
+
+			if (parentItem.first <= item.first)
+				break;
+
+			Place(parentItem, index);
+			index = parent;
+		}
+
+		Place(item, index);
+	}
+	void SiftDown(int index)
+	{
+		HeapItem item = items->Get(index);
+
+		while (2 * index + 1 < itemsCount)
+		{
+			int child = 2 * index + 1;
+
+			if (child + 1 < itemsCount && items->Get(child + 1).first < items->Get(child).first)
+				child++;
+
+			HeapItem childItem = items->Get(child);
+
+			if (item.first <= childItem.first)
+				break;
+
+			Place(childItem, index);
+			index = child;
+		}
+
+		Place(item, index);
+	}
+public:
+	~BinaryHeap()
+	{
+		delete(items);
+		delete(positions);
+	}
+};
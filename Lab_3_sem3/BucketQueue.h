@@ -0,0 +1,209 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "dependencies/DynamicArray.h"
+#include "dependencies/LinkedList.h"
+#include "dependencies/HashMap.h"
+
+#include "IPriorityQueue.h"
+
+using namespace dictionary;
+
+// Dial's queue: bucket for every priority value in a circle of buckets, used as stacks.
+// Works best when priorities in the queue differ by a small amount,
+// as in Dijkstra algorithm with small integer edge weights. Ring grows, if they do not fit.
+// Decreased items are put into a new bucket, and the old entry is skipped when reached
+template<class T>
+class BucketQueue : public IPriorityQueue<T>
+{
+private:
+	DynamicArray<LinkedList<T>*>* buckets;
+
+	// Current priorities of queued items
+	HashMap<T, int>* priorities;
+
+	// No queued item has lower priority. Moved forward while looking for the minimum
+	mutable int lowest;
+	// No queued item has higher priority
+	int highest;
+
+	int itemsCount;
+	// Entries in all buckets, with outdated ones
+	mutable int entriesCount;
+
+	static const int default_size = 64;
+public:
+	// Size is the expected difference between the lowest and the highest priority plus 1
+	BucketQueue(std::function<int(T, int)> hashFunc, int size = default_size) :
+		priorities(new HashMap<T, int>(hashFunc)), lowest(0), highest(0), itemsCount(0), entriesCount(0)
+	{
+		buckets = CreateBuckets(size > 0 ? size : 1);
+	}
+public:
+	void Push(T item, int priority) override
+	{
+		if (priorities->Contains(item))
+			throw std::invalid_argument("Item is already in the queue!");
+
+		Place(item, priority);
+
+		itemsCount++;
+	}
+	void DecreasePriority(T item, int priority) override
+	{
+		if (priority > priorities->Get(item))
+			throw std::invalid_argument("Priority can only be decreased!");
+
+		Place(item, priority);
+	}
+	T PopMin() override
+	{
+		LinkedList<T>* bucket = FindMinBucket();
+
+		T res = bucket->GetFirst();
+
+		bucket->Remove(0);
+		entriesCount--;
+
+		priorities->Remove(res);
+		itemsCount--;
+
+		return res;
+	}
+public:
+	int MinPriority() const override
+	{
+		FindMinBucket();
+
+		return lowest;
+	}
+	bool Contains(T item) const override
+	{
+		return priorities->Contains(item);
+	}
+	int Count() const override
+	{
+		return itemsCount;
+	}
+	bool IsEmpty() const override
+	{
+		return itemsCount == 0;
+	}
+	// Empties buckets in place, going from the lowest one until no entry is left,
+	// outdated ones too. Usually they all lie close above the lowest priority
+	void Clear() override
+	{
+		for (int i = 0; i < buckets->GetCapacity() && entriesCount > 0; i++)
+		{
+			LinkedList<T>* bucket = buckets->Get(BucketIndex(lowest + i));
+
+			entriesCount -= bucket->GetLength();
+
+			while (!bucket->IsEmpty())
+				bucket->Remove(0);
+		}
+
+		priorities->Clear();
+
+		itemsCount = 0;
+	}
+private:
+	void Place(T item, int priority)
+	{
+		if (itemsCount == 0)
+		{
+			lowest = priority;
+			highest = priority;
+		}
+
+		int newLowest = priority < lowest ? priority : lowest;
+		int newHighest = priority > highest ? priority : highest;
+
+		if (newHighest - newLowest >= buckets->GetCapacity())
+			Resize(newHighest - newLowest + 1, newLowest);
+
+		lowest = newLowest;
+		highest = newHighest;
+
+		priorities->Add(item, priority);
+		buckets->Get(BucketIndex(priority))->Prepend(item);
+		entriesCount++;
+	}
+
+	// Skips empty buckets and outdated entries until the lowest bucket has a queued item on top
+	LinkedList<T>* FindMinBucket() const
+	{
+		if (itemsCount == 0)
+			throw std::out_of_range("Queue is empty!");
+
+		while (true)
+		{
+			LinkedList<T>* bucket = buckets->Get(BucketIndex(lowest));
+
+			while (!bucket->IsEmpty())
+			{
+				T top = bucket->GetFirst();
+
+				if (priorities->Contains(top) && priorities->Get(top) == lowest)
+					return bucket;
+
+				bucket->Remove(0);
+				entriesCount--;
+			}
+
+			lowest++;
+		}
+	}
+
+	// Moves queued items into a ring of at least the given size, dropping outdated entries
+	void Resize(int minSize, int newLowest)
+	{
+		int size = buckets->GetCapacity();
+
+		while (size < minSize)
+			size *= 2;
+
+		for (int i = 0; i < buckets->GetCapacity(); i++)
+			delete(buckets->Get(i));
+
+		delete(buckets);
+
+		buckets = CreateBuckets(size);
+		lowest = newLowest;
+		entriesCount = priorities->Count();
+
+		auto iter = priorities->Iterator();
+
+		for (; iter != priorities->End(); ++iter)
+		{
+			buckets->Get(BucketIndex((*iter).second))->Prepend((*iter).first);
+		}
+	}
+
+	int BucketIndex(int priority) const
+	{
+		int index = priority % buckets->GetCapacity();
+
+		return index < 0 ? index + buckets->GetCapacity() : index;
+	}
+
+	static DynamicArray<LinkedList<T>*>* CreateBuckets(int size)
+	{
+		DynamicArray<LinkedList<T>*>* res = new DynamicArray<LinkedList<T>*>(size);
+
+		for (int i = 0; i < size; i++)
+			res->Set(new LinkedList<T>(), i);
+
+		return res;
+	}
+public:
+	~BucketQueue()
+	{
+		for (int i = 0; i < buckets->GetCapacity(); i++)
+			delete(buckets->Get(i));
+
+		delete(buckets);
+		delete(priorities);
+	}
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "dependencies/DynamicArray.h"
+
+#include "Graph.h"
+#include "VertexIndex.h"
+
+// Read-only copy of a graph, where vertices are numbered by VertexIndex and edges
+// of every vertex lie next to each other in flat arrays.
+// Edges of vertex v have numbers from EdgesBegin(v) to EdgesEnd(v) - 1.
+// Reading it from several threads at once is safe
+template<class T>
+class CompactGraph
+{
+private:
+	VertexIndex<T>* index;
+
+	// firstEdge[v] is the number of the first edge of v, firstEdge[VertexCount()] == EdgeCount()
+	DynamicArray<int>* firstEdge;
+	DynamicArray<int>* edgeEnds;
+	DynamicArray<int>* edgeWeights;
+
+	int edgeCount;
+	int maxWeight;
+public:
+	CompactGraph(Graph<T>* graph) :
+		index(new VertexIndex<T>(graph)), edgeCount(0), maxWeight(0)
+	{
+		int vertexCount = index->Count();
+
+		for (int v = 0; v < vertexCount; v++)
+			edgeCount += graph->AdjacentCount(index->VertexAt(v));
+
+		firstEdge = new DynamicArray<int>(vertexCount + 1);
+		edgeEnds = new DynamicArray<int>(edgeCount + 1);
+		edgeWeights = new DynamicArray<int>(edgeCount + 1);
+
+		int edge = 0;
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			firstEdge->Set(edge, v);
+
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(v));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				int weight = (*edgeIter)->GetWeight();
+
+				edgeEnds->Set(index->IndexOf((*edgeIter)->GetEnd()), edge);
+				edgeWeights->Set(weight, edge);
+
+				if (weight > maxWeight)
+					maxWeight = weight;
+
+				edge++;
+			}
+		}
+
+		firstEdge->Set(edge, vertexCount);
+	}
+public:
+	int VertexCount() const
+	{
+		return index->Count();
+	}
+	int EdgeCount() const
+	{
+		return edgeCount;
+	}
+	int MaxWeight() const
+	{
+		return maxWeight;
+	}
+
+	int EdgesBegin(int vertex) const
+	{
+		return firstEdge->Get(vertex);
+	}
+	int EdgesEnd(int vertex) const
+	{
+		return firstEdge->Get(vertex + 1);
+	}
+	int EdgeEnd(int edge) const
+	{
+		return edgeEnds->Get(edge);
+	}
+	int EdgeWeight(int edge) const
+	{
+		return edgeWeights->Get(edge);
+	}
+
+	int IndexOf(T vertex) const
+	{
+		return index->IndexOf(vertex);
+	}
+	T VertexAt(int vertex) const
+	{
+		return index->VertexAt(vertex);
+	}
+public:
+	~CompactGraph()
+	{
+		delete(index);
+		delete(firstEdge);
+		delete(edgeEnds);
+		delete(edgeWeights);
+	}
+};
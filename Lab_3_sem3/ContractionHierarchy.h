@@ -0,0 +1,702 @@
+#pragma once
+
+#include "dependencies/ArraySequence.h"
+#include "dependencies/DynamicArray.h"
+
+#include "Graph.h"
+#include "IndexHeap.h"
+#include "PathfinderWorkspace.h"
+#include "VertexIndex.h"
+
+// Graph prepared for fast point-to-point queries, built once for a graph that does not change.
+// Vertices are contracted one by one, starting from the least important: contracted vertex is
+// removed and shortcuts are added between its neighbours, where the path through it is the only
+// shortest one. Rank of a vertex is its place in that order. Every shortest path can then be found
+// going up by rank from the start and down by rank to the end, so queries look only at edges
+// to higher ranked vertices
+template<class T>
+class ContractionHierarchy
+{
+public:
+	static const int inf = PathfinderWorkspace<T>::inf;
+private:
+	struct Arc
+	{
+		int end;
+		int weight;
+		// Contracted vertex the shortcut goes through, -1 for edges of the graph
+		int middle;
+	};
+
+	VertexIndex<T>* index;
+
+	DynamicArray<int>* rank;
+
+	// Edges from every vertex to higher ranked ones
+	DynamicArray<int>* upwardFirst;
+	DynamicArray<Arc>* upwardArcs;
+	// Edges to every vertex from higher ranked ones, reversed
+	DynamicArray<int>* downwardFirst;
+	DynamicArray<Arc>* downwardArcs;
+
+	int shortcutCount;
+
+	// Remaining graph, used only while contracting. Arcs of a contracted vertex are kept
+	// as they were, and arcs to it are removed from its neighbours
+	DynamicArray<ArraySequence<Arc>*>* outArcs;
+	DynamicArray<ArraySequence<Arc>*>* inArcs;
+	DynamicArray<bool>* contracted;
+	DynamicArray<int>* contractedNeighbours;
+	ArraySequence<Arc>* keptArcs;
+
+	// Labels of the witness search, that looks for paths avoiding the vertex being contracted
+	DynamicArray<int>* witnessDistance;
+	DynamicArray<int>* witnessStamp;
+	IndexHeap* witnessQueue;
+	int stamp;
+
+	// Witness search gives up after checking this many vertices, and a shortcut is added,
+	// even if it might be unnecessary
+	static const int witness_search_limit = 64;
+public:
+	ContractionHierarchy(Graph<T>* graph) :
+		index(new VertexIndex<T>(graph)), shortcutCount(0), stamp(0)
+	{
+		int vertexCount = index->Count();
+
+		rank = new DynamicArray<int>(vertexCount + 1);
+		outArcs = new DynamicArray<ArraySequence<Arc>*>(vertexCount + 1);
+		inArcs = new DynamicArray<ArraySequence<Arc>*>(vertexCount + 1);
+		contracted = new DynamicArray<bool>(vertexCount + 1);
+		contractedNeighbours = new DynamicArray<int>(vertexCount + 1);
+		witnessDistance = new DynamicArray<int>(vertexCount + 1);
+		witnessStamp = new DynamicArray<int>(vertexCount + 1);
+		witnessQueue = new IndexHeap(vertexCount);
+		keptArcs = new ArraySequence<Arc>();
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			outArcs->Set(new ArraySequence<Arc>(), v);
+			inArcs->Set(new ArraySequence<Arc>(), v);
+			contracted->Set(false, v);
+			contractedNeighbours->Set(0, v);
+			witnessStamp->Set(0, v);
+		}
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(v));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				int end = index->IndexOf((*edgeIter)->GetEnd());
+
+				if (end != v)
+					AddArc(v, end, (*edgeIter)->GetWeight(), -1);
+			}
+		}
+
+		Contract();
+
+		BuildSearchGraph(outArcs, upwardFirst, upwardArcs);
+		BuildSearchGraph(inArcs, downwardFirst, downwardArcs);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			delete(outArcs->Get(v));
+			delete(inArcs->Get(v));
+		}
+
+		delete(outArcs);
+		delete(inArcs);
+		delete(contracted);
+		delete(contractedNeighbours);
+		delete(witnessDistance);
+		delete(witnessStamp);
+		delete(witnessQueue);
+		delete(keptArcs);
+	}
+public:
+	int VertexCount() const
+	{
+		return index->Count();
+	}
+	int ShortcutCount() const
+	{
+		return shortcutCount;
+	}
+	int IndexOf(T vertex) const
+	{
+		return index->IndexOf(vertex);
+	}
+	T VertexAt(int vertex) const
+	{
+		return index->VertexAt(vertex);
+	}
+	int Rank(T vertex) const
+	{
+		return rank->Get(index->IndexOf(vertex));
+	}
+
+	// Forward arcs go from the vertex up, backward arcs come into the vertex from above
+	// and lead to where they start from
+	int ArcsBegin(int vertex, bool forward) const
+	{
+		return (forward ? upwardFirst : downwardFirst)->Get(vertex);
+	}
+	int ArcsEnd(int vertex, bool forward) const
+	{
+		return (forward ? upwardFirst : downwardFirst)->Get(vertex + 1);
+	}
+	int ArcEnd(int arc, bool forward) const
+	{
+		return (forward ? upwardArcs : downwardArcs)->Get(arc).end;
+	}
+	int ArcWeight(int arc, bool forward) const
+	{
+		return (forward ? upwardArcs : downwardArcs)->Get(arc).weight;
+	}
+	int ArcMiddle(int arc, bool forward) const
+	{
+		return (forward ? upwardArcs : downwardArcs)->Get(arc).middle;
+	}
+
+	// Appends vertices of the graph path, that arc from -> to stands for, except the first one
+	void Unpack(int from, int to, int middle, Sequence<T>* path) const
+	{
+		if (middle == -1)
+		{
+			path->Append(index->VertexAt(to));
+			return;
+		}
+
+		// Middle vertex was contracted before both ends, so both halves are kept among its arcs
+		Unpack(from, middle, FindMiddle(middle, from, false), path);
+		Unpack(middle, to, FindMiddle(middle, to, true), path);
+	}
+private:
+	// Adds an arc or makes the existing one shorter. Returns false, if the existing one is not longer
+	bool AddArc(int from, int to, int weight, int middle)
+	{
+		ArraySequence<Arc>* out = outArcs->Get(from);
+		ArraySequence<Arc>* in = inArcs->Get(to);
+
+		Arc arc;
+
+		arc.weight = weight;
+		arc.middle = middle;
+
+		for (int i = 0; i < out->GetLength(); i++)
+		{
+			if (out->Get(i).end != to)
+				continue;
+
+			if (out->Get(i).weight <= weight)
+				return false;
+
+			arc.end = to;
+			out->Set(arc, i);
+
+			for (int j = 0; j < in->GetLength(); j++)
+			{
+				if (in->Get(j).end == from)
+				{
+					arc.end = from;
+					in->Set(arc, j);
+				}
+			}
+
+			return true;
+		}
+
+		arc.end = to;
+		out->Append(arc);
+
+		arc.end = from;
+		in->Append(arc);
+
+		return true;
+	}
+
+	// Priorities get outdated as the graph changes, so the least important vertex is checked
+	// again before contracting, and put back if another one became less important
+	void Contract()
+	{
+		int vertexCount = index->Count();
+
+		IndexHeap order(vertexCount);
+
+		for (int v = 0; v < vertexCount; v++)
+			order.Push(v, Priority(v));
+
+		int nextRank = 0;
+
+		while (!order.IsEmpty())
+		{
+			int v = order.PopMin();
+			int priority = Priority(v);
+
+			if (!order.IsEmpty() && priority > order.MinPriority())
+			{
+				order.Push(v, priority);
+				continue;
+			}
+
+			ContractVertex(v, false);
+
+			contracted->Set(true, v);
+			rank->Set(nextRank, v);
+			nextRank++;
+
+			UpdateNeighbours(outArcs->Get(v), order);
+			UpdateNeighbours(inArcs->Get(v), order);
+		}
+	}
+
+	// Edge difference plus count of contracted neighbours, so contraction spreads over the graph
+	int Priority(int vertex)
+	{
+		int removed = LiveCount(outArcs->Get(vertex)) + LiveCount(inArcs->Get(vertex));
+
+		return 2 * (ContractVertex(vertex, true) - removed) + contractedNeighbours->Get(vertex);
+	}
+
+	// Returns count of shortcuts needed to remove the vertex, adds them unless simulating
+	int ContractVertex(int vertex, bool simulate)
+	{
+		ArraySequence<Arc>* in = inArcs->Get(vertex);
+		ArraySequence<Arc>* out = outArcs->Get(vertex);
+
+		int maxOut = 0;
+
+		for (int i = 0; i < out->GetLength(); i++)
+		{
+			if (!contracted->Get(out->Get(i).end) && out->Get(i).weight > maxOut)
+				maxOut = out->Get(i).weight;
+		}
+
+		int shortcuts = 0;
+
+		for (int i = 0; i < in->GetLength(); i++)
+		{
+			Arc inArc = in->Get(i);
+
+			if (contracted->Get(inArc.end))
+				continue;
+
+			WitnessSearch(inArc.end, vertex, inArc.weight + maxOut);
+
+			for (int j = 0; j < out->GetLength(); j++)
+			{
+				Arc outArc = out->Get(j);
+
+				if (contracted->Get(outArc.end) || outArc.end == inArc.end)
+					continue;
+
+				int through = inArc.weight + outArc.weight;
+
+				if (WitnessDistance(outArc.end) <= through)
+					continue;
+
+				shortcuts++;
+
+				if (!simulate && AddArc(inArc.end, outArc.end, through, vertex))
+					shortcutCount++;
+			}
+		}
+
+		return shortcuts;
+	}
+
+	// Dijkstra from the source in the remaining graph without the skipped vertex,
+	// up to the given distance
+	void WitnessSearch(int source, int skipped, int maxDistance)
+	{
+		stamp++;
+
+		witnessQueue->Clear();
+
+		SetWitnessDistance(source, 0);
+		witnessQueue->Push(source, 0);
+
+		int checked = 0;
+
+		while (!witnessQueue->IsEmpty() && checked < witness_search_limit)
+		{
+			if (witnessQueue->MinPriority() > maxDistance)
+				break;
+
+			int tmp = witnessQueue->PopMin();
+			int distance = WitnessDistance(tmp);
+
+			checked++;
+
+			ArraySequence<Arc>* out = outArcs->Get(tmp);
+
+			for (int i = 0; i < out->GetLength(); i++)
+			{
+				Arc arc = out->Get(i);
+
+				if (arc.end == skipped || contracted->Get(arc.end))
+					continue;
+
+				int newDistance = distance + arc.weight;
+
+				if (newDistance >= WitnessDistance(arc.end))
+					continue;
+
+				SetWitnessDistance(arc.end, newDistance);
+
+				if (witnessQueue->Contains(arc.end))
+					witnessQueue->DecreasePriority(arc.end, newDistance);
+				else
+					witnessQueue->Push(arc.end, newDistance);
+			}
+		}
+	}
+
+	int WitnessDistance(int vertex) const
+	{
+		return witnessStamp->Get(vertex) == stamp ? witnessDistance->Get(vertex) : inf;
+	}
+	void SetWitnessDistance(int vertex, int distance)
+	{
+		witnessStamp->Set(stamp, vertex);
+		witnessDistance->Set(distance, vertex);
+	}
+
+	int LiveCount(ArraySequence<Arc>* arcs) const
+	{
+		int res = 0;
+
+		for (int i = 0; i < arcs->GetLength(); i++)
+		{
+			if (!contracted->Get(arcs->Get(i).end))
+				res++;
+		}
+
+		return res;
+	}
+	// Neighbours of a contracted vertex lose arcs to it and may become less important
+	void UpdateNeighbours(ArraySequence<Arc>* arcs, IndexHeap& order)
+	{
+		for (int i = 0; i < arcs->GetLength(); i++)
+		{
+			int end = arcs->Get(i).end;
+
+			if (contracted->Get(end))
+				continue;
+
+			contractedNeighbours->Set(contractedNeighbours->Get(end) + 1, end);
+
+			RemoveContracted(outArcs->Get(end));
+			RemoveContracted(inArcs->Get(end));
+
+			int priority = Priority(end);
+
+			if (order.Contains(end) && priority < order.PriorityOf(end))
+				order.DecreasePriority(end, priority);
+		}
+	}
+	void RemoveContracted(ArraySequence<Arc>* arcs)
+	{
+		keptArcs->Clear();
+
+		for (int i = 0; i < arcs->GetLength(); i++)
+		{
+			if (!contracted->Get(arcs->Get(i).end))
+				keptArcs->Append(arcs->Get(i));
+		}
+
+		arcs->Clear();
+
+		for (int i = 0; i < keptArcs->GetLength(); i++)
+			arcs->Append(keptArcs->Get(i));
+	}
+
+	// Keeps arcs to higher ranked vertices in flat arrays, as CompactGraph does
+	void BuildSearchGraph(DynamicArray<ArraySequence<Arc>*>* arcs, DynamicArray<int>*& first, DynamicArray<Arc>*& result)
+	{
+		int vertexCount = index->Count();
+		int count = 0;
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			for (int i = 0; i < arcs->Get(v)->GetLength(); i++)
+			{
+				if (rank->Get(arcs->Get(v)->Get(i).end) > rank->Get(v))
+					count++;
+			}
+		}
+
+		first = new DynamicArray<int>(vertexCount + 1);
+		result = new DynamicArray<Arc>(count + 1);
+
+		int arc = 0;
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			first->Set(arc, v);
+
+			for (int i = 0; i < arcs->Get(v)->GetLength(); i++)
+			{
+				if (rank->Get(arcs->Get(v)->Get(i).end) > rank->Get(v))
+				{
+					result->Set(arcs->Get(v)->Get(i), arc);
+					arc++;
+				}
+			}
+		}
+
+		first->Set(arc, vertexCount);
+	}
+
+	int FindMiddle(int vertex, int end, bool forward) const
+	{
+		for (int arc = ArcsBegin(vertex, forward); arc < ArcsEnd(vertex, forward); arc++)
+		{
+			if (ArcEnd(arc, forward) == end)
+				return ArcMiddle(arc, forward);
+		}
+
+		throw std::logic_error("Shortcut has no arc to unpack");
+	}
+public:
+	~ContractionHierarchy()
+	{
+		delete(index);
+		delete(rank);
+		delete(upwardFirst);
+		delete(upwardArcs);
+		delete(downwardFirst);
+		delete(downwardArcs);
+	}
+};
+
+// Point-to-point queries on a contraction hierarchy: Dijkstra from both ends at once,
+// both going only up by rank. Vertex, where they meet with the smallest sum of distances,
+// is on the shortest path. Shortcuts of the found path are unpacked into edges of the graph.
+// Hierarchy is not copied, so many pathfinders can share one
+template<class T>
+class ContractionHierarchyPathfinder
+{
+public:
+	static const int inf = ContractionHierarchy<T>::inf;
+private:
+	struct SearchLabel
+	{
+		// Number of the search that wrote this label
+		int stamp;
+
+		int distance;
+		int prev;
+		// Middle vertex of the arc from prev
+		int middle;
+	};
+
+	ContractionHierarchy<T>* hierarchy;
+
+	int startVertex;
+	// End of the latest search, -1 if there was none
+	int targetVertex;
+
+	int bestDistance;
+	int meetingVertex;
+
+	DynamicArray<SearchLabel>* forwardLabels;
+	DynamicArray<SearchLabel>* backwardLabels;
+
+	IndexHeap* forwardQueue;
+	IndexHeap* backwardQueue;
+
+	int stamp;
+	int checkedCount;
+public:
+	ContractionHierarchyPathfinder(ContractionHierarchy<T>* hierarchy, T startVertex) :
+		hierarchy(hierarchy), startVertex(hierarchy->IndexOf(startVertex)), targetVertex(-1),
+		bestDistance(inf), meetingVertex(-1),
+		forwardLabels(new DynamicArray<SearchLabel>(hierarchy->VertexCount() + 1)),
+		backwardLabels(new DynamicArray<SearchLabel>(hierarchy->VertexCount() + 1)),
+		forwardQueue(new IndexHeap(hierarchy->VertexCount())), backwardQueue(new IndexHeap(hierarchy->VertexCount())),
+		stamp(0), checkedCount(0)
+	{
+		SearchLabel empty;
+
+		empty.stamp = 0;
+
+		for (int v = 0; v < hierarchy->VertexCount(); v++)
+		{
+			forwardLabels->Set(empty, v);
+			backwardLabels->Set(empty, v);
+		}
+	}
+
+	int GetDistance(T endVertex)
+	{
+		Search(hierarchy->IndexOf(endVertex));
+
+		return bestDistance;
+	}
+
+	Sequence<T>* GetPath(T endVertex)
+	{
+		Search(hierarchy->IndexOf(endVertex));
+
+		if (bestDistance >= inf)
+			throw vertex_not_found("Vertex was not reached from the start");
+
+		Sequence<T>* path = new ArraySequence<T>();
+
+		// Forward half is collected from the meeting vertex back to the start
+		ArraySequence<int> upward;
+
+		for (int tmp = meetingVertex; tmp != startVertex; tmp = forwardLabels->Get(tmp).prev)
+			upward.Append(tmp);
+
+		path->Append(hierarchy->VertexAt(startVertex));
+
+		int from = startVertex;
+
+		for (int i = upward.GetLength() - 1; i >= 0; i--)
+		{
+			int to = upward.Get(i);
+
+			hierarchy->Unpack(from, to, forwardLabels->Get(to).middle, path);
+			from = to;
+		}
+
+		for (int tmp = meetingVertex; tmp != targetVertex; tmp = backwardLabels->Get(tmp).prev)
+			hierarchy->Unpack(tmp, backwardLabels->Get(tmp).prev, backwardLabels->Get(tmp).middle, path);
+
+		return path;
+	}
+
+	void Restart(T newStart)
+	{
+		startVertex = hierarchy->IndexOf(newStart);
+		targetVertex = -1;
+	}
+
+	// Vertices checked by both searches of the latest query
+	int CheckedCount()
+	{
+		return checkedCount;
+	}
+private:
+	void Search(int end)
+	{
+		if (end == targetVertex)
+			return;
+
+		targetVertex = end;
+		stamp++;
+
+		bestDistance = inf;
+		meetingVertex = -1;
+		checkedCount = 0;
+
+		forwardQueue->Clear();
+		backwardQueue->Clear();
+
+		SetLabel(forwardLabels, startVertex, 0, -1, -1);
+		forwardQueue->Push(startVertex, 0);
+
+		SetLabel(backwardLabels, end, 0, -1, -1);
+		backwardQueue->Push(end, 0);
+
+		while (true)
+		{
+			// Search can stop, when it cannot find anything shorter than the best path so far
+			bool forwardDone = forwardQueue->IsEmpty() || forwardQueue->MinPriority() >= bestDistance;
+			bool backwardDone = backwardQueue->IsEmpty() || backwardQueue->MinPriority() >= bestDistance;
+
+			if (forwardDone && backwardDone)
+				break;
+
+			bool forward = backwardDone ||
+				(!forwardDone && forwardQueue->MinPriority() <= backwardQueue->MinPriority());
+
+			Step(forward);
+		}
+	}
+
+	void Step(bool forward)
+	{
+		DynamicArray<SearchLabel>* labels = forward ? forwardLabels : backwardLabels;
+		IndexHeap* queue = forward ? forwardQueue : backwardQueue;
+
+		int tmp = queue->PopMin();
+		int distance = Distance(labels, tmp);
+		int otherDistance = Distance(forward ? backwardLabels : forwardLabels, tmp);
+
+		checkedCount++;
+
+		if (otherDistance < inf && distance + otherDistance < bestDistance)
+		{
+			bestDistance = distance + otherDistance;
+			meetingVertex = tmp;
+		}
+
+		if (IsStalled(tmp, distance, forward))
+			return;
+
+		for (int arc = hierarchy->ArcsBegin(tmp, forward); arc < hierarchy->ArcsEnd(tmp, forward); arc++)
+		{
+			int end = hierarchy->ArcEnd(arc, forward);
+			int newDistance = distance + hierarchy->ArcWeight(arc, forward);
+
+			if (newDistance >= Distance(labels, end))
+				continue;
+
+			SetLabel(labels, end, newDistance, tmp, hierarchy->ArcMiddle(arc, forward));
+
+			if (queue->Contains(end))
+				queue->DecreasePriority(end, newDistance);
+			else
+				queue->Push(end, newDistance);
+		}
+	}
+
+	// Vertex is reached by a longer path than the one through a higher ranked vertex,
+	// that the search has found already. Its arcs cannot lead to a shortest path
+	bool IsStalled(int vertex, int distance, bool forward) const
+	{
+		DynamicArray<SearchLabel>* labels = forward ? forwardLabels : backwardLabels;
+
+		for (int arc = hierarchy->ArcsBegin(vertex, !forward); arc < hierarchy->ArcsEnd(vertex, !forward); arc++)
+		{
+			int higher = Distance(labels, hierarchy->ArcEnd(arc, !forward));
+
+			if (higher < inf && higher + hierarchy->ArcWeight(arc, !forward) < distance)
+				return true;
+		}
+
+		return false;
+	}
+
+	int Distance(DynamicArray<SearchLabel>* labels, int vertex) const
+	{
+		SearchLabel label = labels->Get(vertex);
+
+		return label.stamp == stamp ? label.distance : inf;
+	}
+	void SetLabel(DynamicArray<SearchLabel>* labels, int vertex, int distance, int prev, int middle)
+	{
+		SearchLabel label;
+
+		label.stamp = stamp;
+		label.distance = distance;
+		label.prev = prev;
+		label.middle = middle;
+
+		labels->Set(label, vertex);
+	}
+public:
+	~ContractionHierarchyPathfinder()
+	{
+		delete(forwardLabels);
+		delete(backwardLabels);
+		delete(forwardQueue);
+		delete(backwardQueue);
+	}
+};
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <atomic>
+
+#include "dependencies/ArraySequence.h"
+#include "dependencies/DynamicArray.h"
+
+#include "CompactGraph.h"
+#include "GraphPathfinder.h"
+#include "ParallelFor.h"
+
+// Shortest paths from one vertex, where vertices are checked in buckets of width delta
+// instead of one by one. All vertices of the current bucket are relaxed at once by
+// several threads: first over light edges (not longer than delta), which can bring
+// vertices back into the same bucket, then over heavy edges, which cannot.
+// A search has many phases, so they run on the long-lived workers of a thread pool,
+// started when the pathfinder is made
+template<class T>
+class DeltaSteppingPathfinder
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	CompactGraph<T>* graph;
+
+	bool ownsGraph;
+
+	// Index of the start vertex in the compact graph
+	int startVertex;
+
+	int delta;
+	int threadCount;
+
+	ThreadPool* pool;
+
+	// Distance in the high 32 bits and previous vertex in the low ones,
+	// so that threads always change both of them together
+	std::atomic<long long>* labels;
+
+	bool algorithmStarted = false;
+
+	// Buckets are relaxed on one thread, if they are smaller than this
+	static const int min_parallel_bucket = 256;
+public:
+	// Delta of 0 or less is picked from the maximum edge weight and average vertex degree
+	DeltaSteppingPathfinder(Graph<T>* graph, T startVertex, int delta = 0, int threadCount = DefaultThreadCount(),
+		ThreadPool* pool = ThreadPool::Shared()) :
+		graph(new CompactGraph<T>(graph)), ownsGraph(true), pool(pool)
+	{
+		Init(startVertex, delta, threadCount);
+	}
+
+	// Compact graph can be shared by many pathfinders, built once for all of them
+	DeltaSteppingPathfinder(CompactGraph<T>* graph, T startVertex, int delta = 0, int threadCount = DefaultThreadCount(),
+		ThreadPool* pool = ThreadPool::Shared()) :
+		graph(graph), ownsGraph(false), pool(pool)
+	{
+		Init(startVertex, delta, threadCount);
+	}
+
+	void DeltaStepping()
+	{
+		if (algorithmStarted)
+			return;
+
+		algorithmStarted = true;
+
+		int vertexCount = graph->VertexCount();
+
+		// All queued distances lie between the current bucket and
+		// the maximum edge weight after it, so buckets can be reused in a circle
+		int bucketCount = graph->MaxWeight() / delta + 2;
+
+		DynamicArray<ArraySequence<int>*> buckets(bucketCount);
+
+		for (int i = 0; i < bucketCount; i++)
+			buckets.Set(new ArraySequence<int>(), i);
+
+		// Number of the bucket vertex is queued in, or -1
+		DynamicArray<int> bucketOf(vertexCount);
+		// Number of the last bucket vertex was checked in, or -1
+		DynamicArray<int> checkedIn(vertexCount);
+
+		for (int i = 0; i < vertexCount; i++)
+		{
+			bucketOf.Set(-1, i);
+			checkedIn.Set(-1, i);
+		}
+
+		// Vertices, which distance was decreased by each thread during the last phase
+		DynamicArray<ArraySequence<int>*> improved(threadCount);
+
+		for (int i = 0; i < threadCount; i++)
+			improved.Set(new ArraySequence<int>(), i);
+
+		ArraySequence<int> frontier;
+		ArraySequence<int> checked;
+
+		// Count of bucket entries, including the ones left behind by vertices
+		// that moved to a closer bucket
+		int queued = 0;
+
+		labels[startVertex].store(Pack(0, -1));
+
+		queued += Enqueue(startVertex, buckets, bucketOf);
+
+		for (int current = 0; queued > 0; current++)
+		{
+			ArraySequence<int>* bucket = buckets.Get(current % bucketCount);
+
+			checked.Clear();
+
+			while (bucket->GetLength() > 0)
+			{
+				frontier.Clear();
+
+				for (int i = 0; i < bucket->GetLength(); i++)
+				{
+					int v = bucket->Get(i);
+
+					if (bucketOf.Get(v) != current)
+						continue;
+
+					bucketOf.Set(-1, v);
+					frontier.Append(v);
+
+					if (checkedIn.Get(v) != current)
+					{
+						checkedIn.Set(current, v);
+						checked.Append(v);
+					}
+				}
+
+				queued -= bucket->GetLength();
+				bucket->Clear();
+
+				Relax(&frontier, true, improved);
+
+				queued += Distribute(improved, buckets, bucketOf);
+			}
+
+			// Distances of checked vertices are final now
+			Relax(&checked, false, improved);
+
+			queued += Distribute(improved, buckets, bucketOf);
+		}
+
+		for (int i = 0; i < bucketCount; i++)
+			delete(buckets.Get(i));
+
+		for (int i = 0; i < threadCount; i++)
+			delete(improved.Get(i));
+	}
+
+	int GetDistance(T endVertex)
+	{
+		DeltaStepping();
+
+		return Distance(graph->IndexOf(endVertex));
+	}
+
+	Sequence<T>* GetPath(T endVertex)
+	{
+		DeltaStepping();
+
+		int tmp = graph->IndexOf(endVertex);
+
+		if (Distance(tmp) >= inf)
+			throw vertex_not_found("Vertex was not reached from the start");
+
+		Sequence<T>* path = new ArraySequence<T>();
+
+		while (tmp != startVertex)
+		{
+			path->Append(graph->VertexAt(tmp));
+			tmp = Prev(tmp);
+		}
+
+		path->Append(graph->VertexAt(tmp));
+
+		int pathLength = path->GetLength();
+
+		//Reverse sequence
+		for (int i = 0; i < pathLength / 2; i++)
+		{
+			path->Swap(i, pathLength - i - 1);
+		}
+
+		return path;
+	}
+
+	int GetDelta()
+	{
+		return delta;
+	}
+
+private:
+	void Init(T start, int bucketWidth, int threads)
+	{
+		startVertex = graph->IndexOf(start);
+
+		threadCount = threads > 0 ? threads : 1;
+
+		pool->Reserve(threadCount);
+
+		delta = bucketWidth;
+
+		if (delta <= 0)
+		{
+			int averageDegree = graph->EdgeCount() / (graph->VertexCount() > 0 ? graph->VertexCount() : 1);
+
+			delta = graph->MaxWeight() / (averageDegree > 0 ? averageDegree : 1);
+		}
+
+		if (delta <= 0)
+			delta = 1;
+
+		labels = new std::atomic<long long>[graph->VertexCount()];
+
+		for (int i = 0; i < graph->VertexCount(); i++)
+			labels[i].store(Pack(inf, -1));
+	}
+
+	// Relaxes either only light or only heavy edges of given vertices
+	void Relax(ArraySequence<int>* vertices, bool light, DynamicArray<ArraySequence<int>*>& improved)
+	{
+		int threads = vertices->GetLength() < min_parallel_bucket ? 1 : threadCount;
+
+		pool->For(vertices->GetLength(), threads, [&](int i, int thread) {
+			int u = vertices->Get(i);
+			int uDistance = Distance(u);
+
+			for (int edge = graph->EdgesBegin(u); edge < graph->EdgesEnd(u); edge++)
+			{
+				int weight = graph->EdgeWeight(edge);
+
+				if ((weight <= delta) != light)
+					continue;
+
+				int v = graph->EdgeEnd(edge);
+
+				if (TryDecrease(v, uDistance + weight, u))
+					improved.Get(thread)->Append(v);
+			}
+		});
+	}
+
+	// Moves improved vertices to the buckets of their new distances,
+	// returns count of new bucket entries
+	int Distribute(DynamicArray<ArraySequence<int>*>& improved, DynamicArray<ArraySequence<int>*>& buckets,
+		DynamicArray<int>& bucketOf)
+	{
+		int added = 0;
+
+		for (int thread = 0; thread < improved.GetCapacity(); thread++)
+		{
+			ArraySequence<int>* vertices = improved.Get(thread);
+
+			for (int i = 0; i < vertices->GetLength(); i++)
+				added += Enqueue(vertices->Get(i), buckets, bucketOf);
+
+			vertices->Clear();
+		}
+
+		return added;
+	}
+
+	int Enqueue(int vertex, DynamicArray<ArraySequence<int>*>& buckets, DynamicArray<int>& bucketOf)
+	{
+		int bucket = Distance(vertex) / delta;
+
+		if (bucketOf.Get(vertex) == bucket)
+			return 0;
+
+		bucketOf.Set(bucket, vertex);
+		buckets.Get(bucket % buckets.GetCapacity())->Append(vertex);
+
+		return 1;
+	}
+
+	// Lowers distance of the vertex, if the new one is smaller. Safe to call from many threads
+	bool TryDecrease(int vertex, int distance, int prev)
+	{
+		long long current = labels[vertex].load();
+		long long desired = Pack(distance, prev);
+
+		while (Unpack(current) > distance)
+		{
+			if (labels[vertex].compare_exchange_weak(current, desired))
+				return true;
+		}
+
+		return false;
+	}
+
+	int Distance(int vertex) const
+	{
+		return Unpack(labels[vertex].load());
+	}
+	int Prev(int vertex) const
+	{
+		return (int)(labels[vertex].load() & 0xFFFFFFFFLL);
+	}
+
+	static long long Pack(int distance, int prev)
+	{
+		return ((long long)distance << 32) | (unsigned int)prev;
+	}
+	static int Unpack(long long label)
+	{
+		return (int)(label >> 32);
+	}
+
+public:
+	~DeltaSteppingPathfinder()
+	{
+		delete[](labels);
+
+		if (ownsGraph)
+			delete(graph);
+	}
+};
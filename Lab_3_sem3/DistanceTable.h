@@ -0,0 +1,100 @@
+#pragma once
+
+#include "dependencies/DynamicArray.h"
+#include "dependencies/Sequence.h"
+
+#include "Graph.h"
+#include "GraphPathfinder.h"
+#include "ParallelFor.h"
+#include "VertexIndex.h"
+
+// Shortest distances from a set of start vertices to every vertex of the graph.
+// Searches from different start vertices are spread over several threads
+template<class T>
+class DistanceTable
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	VertexIndex<T>* sources;
+	VertexIndex<T>* targets;
+
+	// Row for every start vertex, column for every vertex of the graph
+	DynamicArray<int>* distances;
+public:
+	// Distances between all pairs of vertices
+	DistanceTable(Graph<T>* graph, int threadCount = DefaultThreadCount()) :
+		sources(new VertexIndex<T>(graph)), targets(new VertexIndex<T>(graph)),
+		distances(new DynamicArray<int>(sources->Count() * targets->Count() + 1))
+	{
+		Fill(graph, threadCount);
+	}
+
+	DistanceTable(Graph<T>* graph, Sequence<T>* startVertices, int threadCount = DefaultThreadCount()) :
+		sources(new VertexIndex<T>(startVertices, graph->GetHashFunction())), targets(new VertexIndex<T>(graph)),
+		distances(new DynamicArray<int>(sources->Count() * targets->Count() + 1))
+	{
+		// Searches must not fail on the worker threads
+		for (int i = 0; i < sources->Count(); i++)
+		{
+			if (!graph->HasVertex(sources->VertexAt(i)))
+			{
+				delete(sources);
+				delete(targets);
+				delete(distances);
+
+				throw vertex_not_found("Start vertex is not in the graph");
+			}
+		}
+
+		Fill(graph, threadCount);
+	}
+public:
+	int GetDistance(T startVertex, T endVertex) const
+	{
+		return distances->Get(sources->IndexOf(startVertex) * targets->Count() + targets->IndexOf(endVertex));
+	}
+	int SourceCount() const
+	{
+		return sources->Count();
+	}
+	int TargetCount() const
+	{
+		return targets->Count();
+	}
+private:
+	void Fill(Graph<T>* graph, int threadCount)
+	{
+		int columns = targets->Count();
+
+		if (threadCount < 1)
+			threadCount = 1;
+
+		// Every thread reuses its own workspace for all of its searches
+		DynamicArray<PathfinderWorkspace<T>*> workspaces(threadCount);
+
+		for (int i = 0; i < threadCount; i++)
+			workspaces.Set(new PathfinderWorkspace<T>(graph->GetHashFunction()), i);
+
+		ParallelFor(sources->Count(), threadCount, [&](int row, int thread) {
+			DijkstraPathfinder<T> pathfinder(graph, sources->VertexAt(row), workspaces.Get(thread));
+
+			pathfinder.Dijkstra();
+
+			for (int column = 0; column < columns; column++)
+			{
+				distances->Set(pathfinder.GetTentativeDistance(targets->VertexAt(column)), row * columns + column);
+			}
+		});
+
+		for (int i = 0; i < threadCount; i++)
+			delete(workspaces.Get(i));
+	}
+public:
+	~DistanceTable()
+	{
+		delete(sources);
+		delete(targets);
+		delete(distances);
+	}
+};
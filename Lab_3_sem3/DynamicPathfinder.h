@@ -0,0 +1,298 @@
+#pragma once
+
+#include "dependencies/ArraySequence.h"
+#include "dependencies/DynamicArray.h"
+
+#include "Graph.h"
+#include "GraphPathfinder.h"
+#include "IndexHeap.h"
+#include "VertexIndex.h"
+
+// Shortest paths from one vertex, that stay up to date while edge weights change.
+// Edges changed through the pathfinder only repair the part of the shortest path tree
+// they affect (Ramalingam-Reps): a shorter edge spreads new distances from its end,
+// a longer or removed tree edge cuts off its subtree, which is searched again from
+// the vertices around it. Any other change of the graph makes it search from scratch
+template<class T>
+class DynamicPathfinder
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	Graph<T>* graph;
+	// Incoming edges of every vertex, needed to reconnect a cut off subtree
+	Graph<T>* reversedGraph;
+
+	VertexIndex<T>* index;
+
+	T startVertex;
+
+	// Graph version the distances were found for
+	int graphVersion;
+
+	DynamicArray<int>* distances;
+	// Previous vertex on the shortest path, -1 for the start and unreachable vertices
+	DynamicArray<int>* prev;
+	// Vertices of the cut off subtree
+	DynamicArray<bool>* affected;
+	ArraySequence<int>* affectedVertices;
+
+	IndexHeap* queue;
+
+	// Vertices checked by the latest update or full search
+	int checkedCount;
+public:
+	DynamicPathfinder(Graph<T>* graph, T startVertex) :
+		graph(graph), reversedGraph(nullptr), index(nullptr), startVertex(startVertex),
+		distances(nullptr), prev(nullptr), affected(nullptr), affectedVertices(new ArraySequence<int>()),
+		queue(nullptr), checkedCount(0)
+	{
+		if (!graph->HasVertex(startVertex))
+			throw vertex_not_found("No such vertex in the graph");
+
+		Recompute();
+	}
+
+	int GetDistance(T endVertex)
+	{
+		Refresh();
+
+		return distances->Get(index->IndexOf(endVertex));
+	}
+
+	Sequence<T>* GetPath(T endVertex)
+	{
+		Refresh();
+
+		int end = index->IndexOf(endVertex);
+
+		if (distances->Get(end) >= inf)
+			throw vertex_not_found("Vertex was not reached from the start");
+
+		Sequence<T>* path = new ArraySequence<T>();
+
+		for (int tmp = end; tmp != -1; tmp = prev->Get(tmp))
+			path->Append(index->VertexAt(tmp));
+
+		int pathLength = path->GetLength();
+
+		for (int i = 0; i < pathLength / 2; i++)
+			path->Swap(i, pathLength - i - 1);
+
+		return path;
+	}
+
+	// Sets the edge in the graph and repairs distances it changes
+	void SetAdjacent(T edgeStart, T edgeEnd, int length)
+	{
+		Refresh();
+
+		Edge<T>* edge = graph->GetEdge(edgeStart, edgeEnd);
+		int oldLength = edge == nullptr ? inf : edge->GetWeight();
+
+		graph->SetAdjacent(edgeStart, edgeEnd, length);
+		reversedGraph->SetAdjacent(edgeEnd, edgeStart, length);
+
+		graphVersion = graph->Version();
+
+		Repair(index->IndexOf(edgeStart), index->IndexOf(edgeEnd), oldLength, length);
+	}
+
+	void SetBidirectionalEdge(T vertex1, T vertex2, int length)
+	{
+		SetAdjacent(vertex1, vertex2, length);
+		SetAdjacent(vertex2, vertex1, length);
+	}
+
+	// Removes the edge from the graph and repairs distances it changes
+	void RemoveAdjacent(T edgeStart, T edgeEnd)
+	{
+		Refresh();
+
+		Edge<T>* edge = graph->GetEdge(edgeStart, edgeEnd);
+
+		if (edge == nullptr)
+			throw vertex_not_found("No such edge in the graph");
+
+		int oldLength = edge->GetWeight();
+
+		graph->RemoveAdjacent(edgeStart, edgeEnd);
+		reversedGraph->RemoveAdjacent(edgeEnd, edgeStart);
+
+		graphVersion = graph->Version();
+
+		Repair(index->IndexOf(edgeStart), index->IndexOf(edgeEnd), oldLength, inf);
+	}
+
+	// Forgets everything and searches the whole graph again
+	void Recompute()
+	{
+		Release();
+
+		reversedGraph = graph->Transposed();
+		index = new VertexIndex<T>(graph);
+
+		int vertexCount = index->Count();
+
+		distances = new DynamicArray<int>(vertexCount + 1);
+		prev = new DynamicArray<int>(vertexCount + 1);
+		affected = new DynamicArray<bool>(vertexCount + 1);
+		queue = new IndexHeap(vertexCount);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			distances->Set(inf, v);
+			prev->Set(-1, v);
+			affected->Set(false, v);
+		}
+
+		graphVersion = graph->Version();
+		checkedCount = 0;
+
+		int start = index->IndexOf(startVertex);
+
+		distances->Set(0, start);
+		queue->Push(start, 0);
+
+		Propagate();
+	}
+
+	int CheckedCount()
+	{
+		return checkedCount;
+	}
+private:
+	// Graph was changed by someone else, so nothing found before can be trusted
+	void Refresh()
+	{
+		if (graph->Version() != graphVersion)
+			Recompute();
+	}
+
+	void Repair(int from, int to, int oldLength, int newLength)
+	{
+		checkedCount = 0;
+
+		int fromDistance = distances->Get(from);
+
+		if (newLength < oldLength)
+		{
+			if (fromDistance < inf && fromDistance + newLength < distances->Get(to))
+			{
+				Relax(to, fromDistance + newLength, from);
+				Propagate();
+			}
+		}
+		else if (newLength > oldLength && prev->Get(to) == from)
+		{
+			CutSubtree(to);
+			Reconnect();
+			Propagate();
+		}
+	}
+
+	// Marks every vertex, whose shortest path goes through the root, as unreachable
+	void CutSubtree(int root)
+	{
+		affectedVertices->Clear();
+		affectedVertices->Append(root);
+		affected->Set(true, root);
+
+		for (int i = 0; i < affectedVertices->GetLength(); i++)
+		{
+			int tmp = affectedVertices->Get(i);
+
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(tmp));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				int end = index->IndexOf((*edgeIter)->GetEnd());
+
+				if (prev->Get(end) == tmp && !affected->Get(end))
+				{
+					affected->Set(true, end);
+					affectedVertices->Append(end);
+				}
+			}
+		}
+
+		for (int i = 0; i < affectedVertices->GetLength(); i++)
+		{
+			distances->Set(inf, affectedVertices->Get(i));
+			prev->Set(-1, affectedVertices->Get(i));
+		}
+	}
+
+	// Queues every cut off vertex with the best edge coming from the rest of the tree
+	void Reconnect()
+	{
+		for (int i = 0; i < affectedVertices->GetLength(); i++)
+		{
+			int tmp = affectedVertices->Get(i);
+
+			auto edgeIter = reversedGraph->AdjacentIterator(index->VertexAt(tmp));
+
+			for (; edgeIter != reversedGraph->AdjacentEnd(); ++edgeIter)
+			{
+				int start = index->IndexOf((*edgeIter)->GetEnd());
+				int startDistance = distances->Get(start);
+
+				if (!affected->Get(start) && startDistance < inf)
+					Relax(tmp, startDistance + (*edgeIter)->GetWeight(), start);
+			}
+		}
+
+		for (int i = 0; i < affectedVertices->GetLength(); i++)
+			affected->Set(false, affectedVertices->Get(i));
+	}
+
+	// Dijkstra from the queued vertices, that stops where distances do not get shorter
+	void Propagate()
+	{
+		while (!queue->IsEmpty())
+		{
+			int tmp = queue->PopMin();
+			int distance = distances->Get(tmp);
+
+			checkedCount++;
+
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(tmp));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				Relax(index->IndexOf((*edgeIter)->GetEnd()), distance + (*edgeIter)->GetWeight(), tmp);
+			}
+		}
+	}
+
+	void Relax(int vertex, int distance, int from)
+	{
+		if (distance >= distances->Get(vertex))
+			return;
+
+		distances->Set(distance, vertex);
+		prev->Set(from, vertex);
+
+		if (queue->Contains(vertex))
+			queue->DecreasePriority(vertex, distance);
+		else
+			queue->Push(vertex, distance);
+	}
+
+	void Release()
+	{
+		delete(reversedGraph);
+		delete(index);
+		delete(distances);
+		delete(prev);
+		delete(affected);
+		delete(queue);
+	}
+public:
+	~DynamicPathfinder()
+	{
+		Release();
+
+		delete(affectedVertices);
+	}
+};
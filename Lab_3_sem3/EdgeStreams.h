@@ -0,0 +1,123 @@
+#pragma once
+
+#include "dependencies/DynamicArray.h"
+
+// Stream through one edge of the graph
+template<class T>
+class EdgeStream
+{
+private:
+	T startVertex;
+	T endVertex;
+
+	int stream;
+public:
+	EdgeStream(T startVertex, T endVertex, int stream) :
+		startVertex(startVertex), endVertex(endVertex), stream(stream)
+	{}
+
+	T GetStart() const
+	{
+		return startVertex;
+	}
+	T GetEnd() const
+	{
+		return endVertex;
+	}
+	int GetStream() const
+	{
+		return stream;
+	}
+};
+
+// Stream through every edge of the graph, in the order the graph lists them: vertices as
+// the graph iterates them, edges of every vertex as AdjacentIterator gives them.
+// Kept in flat arrays, so it takes three numbers per edge instead of a second graph
+template<class T>
+class EdgeStreams
+{
+private:
+	DynamicArray<T>* starts;
+	DynamicArray<T>* ends;
+	DynamicArray<int>* streams;
+
+	int count;
+public:
+	class Iterator
+	{
+	private:
+		const EdgeStreams<T>* edgeStreams;
+		int edge;
+	public:
+		Iterator(const EdgeStreams<T>* edgeStreams, int edge) :
+			edgeStreams(edgeStreams), edge(edge)
+		{}
+
+		EdgeStream<T> operator*() const
+		{
+			return EdgeStream<T>(edgeStreams->StartAt(edge), edgeStreams->EndAt(edge), edgeStreams->StreamAt(edge));
+		}
+
+		Iterator& operator++()
+		{
+			edge++;
+
+			return *this;
+		}
+
+		bool operator==(const Iterator& other) const
+		{
+			return edgeStreams == other.edgeStreams && edge == other.edge;
+		}
+		bool operator!=(const Iterator& other) const
+		{
+			return !(*this == other);
+		}
+	};
+public:
+	EdgeStreams(int count) :
+		starts(new DynamicArray<T>(count + 1)), ends(new DynamicArray<T>(count + 1)),
+		streams(new DynamicArray<int>(count + 1)), count(count)
+	{}
+public:
+	int Count() const
+	{
+		return count;
+	}
+
+	T StartAt(int edge) const
+	{
+		return starts->Get(edge);
+	}
+	T EndAt(int edge) const
+	{
+		return ends->Get(edge);
+	}
+	int StreamAt(int edge) const
+	{
+		return streams->Get(edge);
+	}
+
+	void Set(int edge, T startVertex, T endVertex, int stream)
+	{
+		starts->Set(startVertex, edge);
+		ends->Set(endVertex, edge);
+		streams->Set(stream, edge);
+	}
+
+	Iterator begin() const
+	{
+		return Iterator(this, 0);
+	}
+	Iterator end() const
+	{
+		return Iterator(this, count);
+	}
+public:
+	~EdgeStreams()
+	{
+		delete(starts);
+		delete(ends);
+		delete(streams);
+	}
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "dependencies/ArraySequence.h"
+
+#include "Graph.h"
+#include "GraphPathfinder.h"
+#include "ParallelFor.h"
+#include "VertexIndex.h"
+
+// Shortest distances between all pairs of vertices, found by Floyd-Warshall algorithm
+// on a distance matrix kept in one plain array. Better than a search from every vertex
+// for dense graphs, where the number of edges is close to the number of pairs.
+// Matrix is processed in square tiles, small enough to stay in cache: for every block of
+// intermediate vertices, first the tile on the diagonal is updated, then the tiles in its
+// row and column, then all the others. Tiles of one step do not depend on each other,
+// so they are spread over several threads
+template<class T>
+class FloydWarshallTable
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	VertexIndex<T>* index;
+
+	int vertexCount;
+
+	// Row for every start vertex, column for every end vertex
+	int* distances;
+	// Vertex after the start on the shortest path, -1 if the end is unreachable
+	int* nextHops;
+
+	// Tile update goes through distances and next hops of the tile, distances of the middle
+	// row, and distances and next hops of the middle column: five tiles of this size take
+	// 20 KB, so they stay in a 32 KB L1 cache
+	static const int tile_size = 32;
+public:
+	FloydWarshallTable(Graph<T>* graph, int threadCount = DefaultThreadCount()) :
+		index(new VertexIndex<T>(graph)), vertexCount(index->Count())
+	{
+		distances = new int[vertexCount * vertexCount + 1];
+		nextHops = new int[vertexCount * vertexCount + 1];
+
+		for (int i = 0; i < vertexCount * vertexCount; i++)
+		{
+			distances[i] = inf;
+			nextHops[i] = -1;
+		}
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			distances[v * vertexCount + v] = 0;
+			nextHops[v * vertexCount + v] = v;
+
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(v));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				int end = index->IndexOf((*edgeIter)->GetEnd());
+
+				if (end != v)
+				{
+					distances[v * vertexCount + end] = (*edgeIter)->GetWeight();
+					nextHops[v * vertexCount + end] = end;
+				}
+			}
+		}
+
+		Fill(threadCount);
+	}
+public:
+	int GetDistance(T startVertex, T endVertex) const
+	{
+		return distances[index->IndexOf(startVertex) * vertexCount + index->IndexOf(endVertex)];
+	}
+
+	Sequence<T>* GetPath(T startVertex, T endVertex) const
+	{
+		int tmp = index->IndexOf(startVertex);
+		int end = index->IndexOf(endVertex);
+
+		if (nextHops[tmp * vertexCount + end] == -1)
+			throw vertex_not_found("Vertex is unreachable from the start");
+
+		Sequence<T>* path = new ArraySequence<T>();
+
+		path->Append(startVertex);
+
+		while (tmp != end)
+		{
+			tmp = nextHops[tmp * vertexCount + end];
+			path->Append(index->VertexAt(tmp));
+		}
+
+		return path;
+	}
+
+	// Next vertex after the start on the shortest path to the end vertex
+	T NextHop(T startVertex, T endVertex) const
+	{
+		int next = nextHops[index->IndexOf(startVertex) * vertexCount + index->IndexOf(endVertex)];
+
+		if (next == -1)
+			throw vertex_not_found("Vertex is unreachable from the start");
+
+		return index->VertexAt(next);
+	}
+
+	int VertexCount() const
+	{
+		return vertexCount;
+	}
+private:
+	void Fill(int threadCount)
+	{
+		int tileCount = (vertexCount + tile_size - 1) / tile_size;
+
+		if (threadCount < 1)
+			threadCount = 1;
+
+		for (int middle = 0; middle < tileCount; middle++)
+		{
+			UpdateTile(middle, middle, middle);
+
+			// Tiles of the same row and column as the diagonal one, except it
+			ParallelFor(2 * (tileCount - 1), threadCount, [&](int i, int thread) {
+				int other = i / 2 < middle ? i / 2 : i / 2 + 1;
+
+				if (i % 2 == 0)
+					UpdateTile(middle, other, middle);
+				else
+					UpdateTile(other, middle, middle);
+			});
+
+			ParallelFor((tileCount - 1) * (tileCount - 1), threadCount, [&](int i, int thread) {
+				int row = i / (tileCount - 1);
+				int column = i % (tileCount - 1);
+
+				UpdateTile(row < middle ? row : row + 1, column < middle ? column : column + 1, middle);
+			});
+		}
+	}
+
+	// Shortens paths inside the tile through the intermediate vertices of the middle tile.
+	// Inner loop has no branches and goes along one row, so the compiler can vectorize it
+	void UpdateTile(int row, int column, int middle)
+	{
+		int rowEnd = TileEnd(row);
+		int columnBegin = column * tile_size;
+		int columnEnd = TileEnd(column);
+		int middleEnd = TileEnd(middle);
+
+		for (int k = middle * tile_size; k < middleEnd; k++)
+		{
+			const int* fromMiddle = distances + k * vertexCount;
+
+			for (int i = row * tile_size; i < rowEnd; i++)
+			{
+				int toMiddle = distances[i * vertexCount + k];
+
+				if (toMiddle >= inf)
+					continue;
+
+				int hop = nextHops[i * vertexCount + k];
+
+				int* rowDistances = distances + i * vertexCount;
+				int* rowHops = nextHops + i * vertexCount;
+
+				for (int j = columnBegin; j < columnEnd; j++)
+				{
+					int through = toMiddle + fromMiddle[j];
+					bool shorter = through < rowDistances[j];
+
+					rowDistances[j] = shorter ? through : rowDistances[j];
+					rowHops[j] = shorter ? hop : rowHops[j];
+				}
+			}
+		}
+	}
+
+	int TileEnd(int tile) const
+	{
+		int end = (tile + 1) * tile_size;
+
+		return end < vertexCount ? end : vertexCount;
+	}
+public:
+	~FloydWarshallTable()
+	{
+		delete(index);
+		delete[](distances);
+		delete[](nextHops);
+	}
+};
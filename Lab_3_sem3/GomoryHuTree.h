@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "dependencies/DynamicArray.h"
+
+#include "Graph.h"
+#include "MaxStreamFinder.h"
+#include "MinCut.h"
+#include "VertexIndex.h"
+
+// Maximum streams between all pairs of vertices of an undirected network, where every edge
+// has the opposite one with the same capacity. Built by Gusfield algorithm with
+// VertexCount() - 1 searches of a maximum stream: every vertex but the first is cut from
+// its parent in the tree, and the vertices after it on its side of the cut move under it.
+// Stream between any two vertices is the smallest capacity on the tree path between them
+template<class T>
+class GomoryHuTree
+{
+private:
+	VertexIndex<T>* index;
+
+	int vertexCount;
+
+	// Parent of every vertex in the tree, -1 for the root
+	DynamicArray<int>* parents;
+	// Capacity of the edge from every vertex to its parent
+	DynamicArray<int>* capacities;
+	// Number of edges from the root
+	DynamicArray<int>* depths;
+public:
+	GomoryHuTree(Graph<T>* graph) :
+		index(new VertexIndex<T>(graph)), vertexCount(index->Count())
+	{
+		parents = new DynamicArray<int>(vertexCount + 1);
+		capacities = new DynamicArray<int>(vertexCount + 1);
+		depths = new DynamicArray<int>(vertexCount + 1);
+
+		// Vertices on the side of the latest cut
+		DynamicArray<bool> onSide(vertexCount + 1);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			parents->Set(v == 0 ? -1 : 0, v);
+			capacities->Set(0, v);
+		}
+
+		for (int v = 1; v < vertexCount; v++)
+		{
+			DinicStreamFinder<T> finder(graph, index->VertexAt(v), index->VertexAt(parents->Get(v)));
+
+			capacities->Set(finder.FindStream(), v);
+
+			MinCut<T>* cut = finder.GetMinCut();
+
+			for (int u = 0; u < vertexCount; u++)
+				onSide.Set(false, u);
+
+			for (int i = 0; i < cut->SourceSide()->GetLength(); i++)
+				onSide.Set(true, index->IndexOf(cut->SourceSide()->Get(i)));
+
+			for (int u = v + 1; u < vertexCount; u++)
+				if (onSide.Get(u) && parents->Get(u) == parents->Get(v))
+					parents->Set(v, u);
+
+			delete(cut);
+		}
+
+		// Parent always goes before the vertex
+		for (int v = 0; v < vertexCount; v++)
+			depths->Set(v == 0 ? 0 : depths->Get(parents->Get(v)) + 1, v);
+	}
+public:
+	// Value of the maximum stream between two vertices, the same both ways
+	int GetStream(T firstVertex, T secondVertex) const
+	{
+		if (firstVertex == secondVertex)
+			throw std::invalid_argument("Start and end of a stream cannot be the same vertex!");
+
+		int first = index->IndexOf(firstVertex);
+		int second = index->IndexOf(secondVertex);
+
+		int res = -1;
+
+		while (first != second)
+		{
+			if (depths->Get(first) < depths->Get(second))
+			{
+				int tmp = first;
+				first = second;
+				second = tmp;
+			}
+
+			if (res == -1 || capacities->Get(first) < res)
+				res = capacities->Get(first);
+
+			first = parents->Get(first);
+		}
+
+		return res;
+	}
+
+	// Parent of the vertex in the tree, the vertex itself for the root
+	T Parent(T vertex) const
+	{
+		int parent = parents->Get(index->IndexOf(vertex));
+
+		return parent == -1 ? vertex : index->VertexAt(parent);
+	}
+	// Capacity of the tree edge from the vertex to its parent, 0 for the root
+	int ParentCapacity(T vertex) const
+	{
+		return capacities->Get(index->IndexOf(vertex));
+	}
+
+	int VertexCount() const
+	{
+		return vertexCount;
+	}
+public:
+	~GomoryHuTree()
+	{
+		delete(index);
+		delete(parents);
+		delete(capacities);
+		delete(depths);
+	}
+};
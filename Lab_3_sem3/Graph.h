@@ -16,9 +16,12 @@ private:
 	IDictionary<T, AdjacencyList<T>*>* vertices;
 
 	std::function<int(T, int)> hashFunction;
+
+	// Changed by every method that changes vertices or edges
+	int version;
 public:
 	Graph(std::function<int(T, int)> hashFunc):
-		vertices(new HashMap<T, AdjacencyList<T>*>(hashFunc)), hashFunction(hashFunc)
+		vertices(new HashMap<T, AdjacencyList<T>*>(hashFunc)), hashFunction(hashFunc), version(0)
 	{}
 
 	int VertexCount()
@@ -26,6 +29,17 @@ public:
 		return vertices->Count();
 	}
 
+	// Results computed for one version are out of date, as soon as it changes
+	int Version()
+	{
+		return version;
+	}
+
+	bool HasVertex(T vertex)
+	{
+		return vertices->Contains(vertex);
+	}
+
 	Edge<T>* GetEdge(T edgeStart, T edgeEnd)
 	{
 		return TryGetAdjacent(edgeStart)->GetEdge(edgeEnd);
@@ -57,6 +71,8 @@ public:
 	void AddVertex(T vertex)
 	{
 		vertices->Add(vertex, new AdjacencyList<T>());
+
+		version++;
 	}
 
 	void RemoveVertex(T vertex)
@@ -73,6 +89,29 @@ public:
 		}
 
 		vertices->Remove(vertex);
+
+		version++;
+	}
+
+	// Length of the longest edge, 0 if there are no edges
+	int MaxEdgeWeight()
+	{
+		int res = 0;
+
+		GraphIterator iter = begin();
+
+		for (; iter != end(); ++iter)
+		{
+			auto edgeIter = AdjacentIterator((*iter).first);
+
+			for (; edgeIter != AdjacentEnd(); ++edgeIter)
+			{
+				if ((*edgeIter)->GetWeight() > res)
+					res = (*edgeIter)->GetWeight();
+			}
+		}
+
+		return res;
 	}
 
 	int AdjacentCount(T vertex)
@@ -88,6 +127,8 @@ public:
 		TryGetAdjacent(edgeEnd);
 
 		TryGetAdjacent(edgeStart)->SetAdjacent(edgeEnd, length);
+
+		version++;
 	}
 
 	void SetBidirectionalEdge(T vertex1, T vertex2, int length)
@@ -99,6 +140,8 @@ public:
 	void RemoveAdjacent(T edgeStart, T edgeEnd)
 	{
 		TryGetAdjacent(edgeStart)->RemoveAdjacent(edgeEnd);
+
+		version++;
 	}
 
 	void RemoveBidirectionalEdge(T vertex1, T vertex2)
@@ -118,6 +161,34 @@ public:
 		return hashFunction;
 	}
 
+	// New graph with the same vertices and every edge pointing the other way
+	Graph<T>* Transposed()
+	{
+		Graph<T>* res = new Graph<T>(hashFunction);
+
+		GraphIterator iter = begin();
+
+		for (; iter != end(); ++iter)
+		{
+			res->AddVertex((*iter).first);
+		}
+
+		iter = begin();
+
+		for (; iter != end(); ++iter)
+		{
+			auto edgeStart = (*iter).first;
+			auto edgeIter = AdjacentIterator(edgeStart);
+
+			for (; edgeIter != AdjacentEnd(); ++edgeIter)
+			{
+				res->SetAdjacent((*edgeIter)->GetEnd(), edgeStart, (*edgeIter)->GetWeight());
+			}
+		}
+
+		return res;
+	}
+
 public:
 	AdjacentVerticesIterator AdjacentIterator(T vertex)
 	{
@@ -128,6 +128,32 @@ public:
 		return res;
 	}
 
+	// Vertex in column x and row y gets number y * width + x,
+	// each vertex is connected with its neighbours to the left, right, top and bottom
+	static Graph<int>* Grid(size_t width, size_t height, int defaultLength = 1)
+	{
+		CheckVerticesMinimum(width, 1, "Grid must contain at least 1 column");
+		CheckVerticesMinimum(height, 1, "Grid must contain at least 1 row");
+
+		Graph<int>* res = Empty(width * height);
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				int vertex = y * width + x;
+
+				if (x + 1 < width)
+					res->SetBidirectionalEdge(vertex, vertex + 1, defaultLength);
+
+				if (y + 1 < height)
+					res->SetBidirectionalEdge(vertex, vertex + width, defaultLength);
+			}
+		}
+
+		return res;
+	}
+
 private:
 	static void AddConnection(Graph<int>* graph, int vertex1, int vertex2, int distance, Direction direction)
 	{
@@ -4,112 +4,212 @@
 
 #include "Graph.h"
 #include "Optional.h"
+#include "PathfinderWorkspace.h"
 #include "dependencies/ArraySequence.h"
+#include "dependencies/DynamicArray.h"
 
 template<class T>
 class DijkstraPathfinder
 {
 public:
-	static const int inf = std::numeric_limits<int>::max() / 2;
+	static const int inf = PathfinderWorkspace<T>::inf;
+
+	// Goes along the path backwards, from the end vertex to the start, reading previous
+	// vertices straight from the workspace. Valid until the search is restarted
+	class ReversePathIterator
+	{
+	private:
+		PathfinderWorkspace<T>* workspace;
+
+		T startVertex;
+		T current;
+
+		bool finished;
+	public:
+		ReversePathIterator(PathfinderWorkspace<T>* workspace, T startVertex, T endVertex) :
+			workspace(workspace), startVertex(startVertex), current(endVertex), finished(false)
+		{}
+
+		T operator*() const
+		{
+			return current;
+		}
+		ReversePathIterator& operator++()
+		{
+			if (current == startVertex)
+				finished = true;
+			else
+				current = workspace->GetPrev(current);
+
+			return *this;
+		}
+		bool IsFinished() const
+		{
+			return finished;
+		}
+	};
 private:
 	Graph<T>* graph;
-	int n;
 
-	//Sequence<int>* distances;
-	//Sequence<bool>* checked;
-	//Sequence<T>* prev;
-	IDictionary<T, int>* distances;
-	IDictionary<T, bool>* checked;//TODO keep in linked list instead
-	IDictionary<T, T>* prev;
+	// Distances, checked vertices, previous vertices and the queue
+	PathfinderWorkspace<T>* workspace;
+
+	bool ownsWorkspace;
 
 	T startVertex;
 
-	bool algorithmStarted = false;
+	int checkedCount = 0;
 
 public:
-	DijkstraPathfinder(Graph<T>* graph, T startVertex) :
-		graph(graph), startVertex(startVertex), n(graph->VertexCount()),
-		distances(new HashMap<T, int>(graph->GetHashFunction())),
-		checked(new HashMap<T, bool>(graph->GetHashFunction())),
-		prev(new HashMap<T, T>(graph->GetHashFunction()))
+	// Queue types, that depend on edge weights, look through the whole graph first
+	DijkstraPathfinder(Graph<T>* graph, T startVertex, QueueType queueType = QueueType::BINARY_HEAP) :
+		graph(graph), startVertex(startVertex), ownsWorkspace(true)
 	{
-		
-		auto iter = graph->begin();
+		if (queueType == QueueType::BUCKETS || queueType == QueueType::AUTO)
+			workspace = new PathfinderWorkspace<T>(graph, queueType);
+		else
+			workspace = new PathfinderWorkspace<T>(graph->GetHashFunction(), queueType);
 
-		for (; iter != graph->end(); ++iter)
-		{
-			distances->Add((*iter).first, inf);
-			checked->Add((*iter).first, false);
-		}
-		
-		distances->Add(startVertex, 0);
+		Restart();
+	}
+
+	// Workspace is not copied, so searches from many start vertices can run one after
+	// another without allocating anything. Only the latest pathfinder created
+	// with a workspace (or restarted) can be used
+	DijkstraPathfinder(Graph<T>* graph, T startVertex, PathfinderWorkspace<T>* workspace) :
+		graph(graph), startVertex(startVertex), workspace(workspace), ownsWorkspace(false)
+	{
+		Restart();
 	}
 
 	void Dijkstra()
 	{
-		algorithmStarted = true;
+		// When queue is empty, all vertices left unchecked are unreachable
+		while (HasUnchecked())
+			CheckNext();
+	}
+
+	// Stops as soon as endVertex is checked, so its distance is final.
+	// Calling it again with another vertex continues the same search
+	void DijkstraUntil(T endVertex)
+	{
+		if (!graph->HasVertex(endVertex))
+			throw vertex_not_found("No such vertex in the graph");
 
-		for (int i = 0; i < n; i++)
-		{
-			//std::cout << *dynamic_cast<HashMap<T, int>*>(distances) << std::endl;
+		while (!workspace->IsChecked(endVertex) && HasUnchecked())
+			CheckNext();
+	}
 
-			Optional<T> v = Optional<T>();
+	virtual int GetDistance(T endVertex)
+	{
+		DijkstraUntil(endVertex);
 
-			auto iter = graph->begin();
+		return workspace->GetDistance(endVertex);
+	}
 
-			// For temporarily keeping vertices
-			T tmp;
+	// Starts a new search from another vertex, reusing the same workspace
+	void Restart(T newStartVertex)
+	{
+		startVertex = newStartVertex;
 
-			//Finding unchecked vertex with closest distance
-			for (; iter != graph->end(); ++iter)
-			{
-				tmp = (*iter).first;
-				if (!checked->Get(tmp) &&
-					(!v.HasValue() || distances->Get(tmp) < distances->Get(*v)))
-				{
-					v.SetValue(tmp);
-				}
-			}
+		Restart();
+	}
 
-			// If minimum distance is infinity, some vertices are unreachable
-			// and we found ways to everything that's reachable
-			if (distances->Get(*v) == inf)
-				break;
-			
-			checked->Add(*v, true);
-			
-			auto edgeIter = graph->AdjacentIterator(*v);
+	bool IsChecked(T vertex)
+	{
+		return workspace->IsChecked(vertex);
+	}
 
-			//Relaxation
-			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
-			{
-				tmp = (*edgeIter)->GetEnd();
-				int len = (*edgeIter)->GetWeight();
+	bool HasUnchecked()
+	{
+		return !workspace->Queue()->IsEmpty();
+	}
 
-				if (distances->Get(*v) + len < distances->Get(tmp))
-				{
-					distances->Add(tmp, distances->Get(*v) + len);
-					prev->Add(tmp, *v);
-				}
+	// Distance to the closest reached, but not checked vertex
+	// (plus its potential, if the pathfinder uses one)
+	int MinUncheckedDistance()
+	{
+		return workspace->Queue()->MinPriority();
+	}
 
-			}
-			
+	// Distance found so far, final only if the vertex is checked
+	int GetTentativeDistance(T vertex)
+	{
+		return workspace->GetDistance(vertex);
+	}
+
+	int CheckedCount()
+	{
+		return checkedCount;
+	}
+
+	// Vertices not farther than radius from the start, with their distances, closest first.
+	// Search starts over and stops at the first vertex farther than radius, so it only
+	// looks at the vertices found and the edges leaving them. Later queries continue it
+	virtual Sequence<std::pair<T, int>>* GetWithin(int radius)
+	{
+		Restart();
+
+		Sequence<std::pair<T, int>>* res = new ArraySequence<std::pair<T, int>>();
+
+		while (HasUnchecked() && MinUncheckedDistance() <= radius)
+		{
+			T v = CheckNext();
+
+			res->Append(std::make_pair(v, workspace->GetDistance(v)));
 		}
+
+		return res;
 	}
 
-	int GetDistance(T endVertex)
+	virtual Sequence<T>* GetPath(T endVertex)
 	{
-		if (!algorithmStarted)
-			Dijkstra();
+		DijkstraUntil(endVertex);
 
-		return distances->Get(endVertex);
+		return GetTentativePath(endVertex);
 	}
 
-	Sequence<T>* GetPath(T endVertex)
+	// Writes the path into the buffer from its beginning and returns the number of its vertices.
+	// Buffer is only resized if the path does not fit, so reusing one buffer for many paths
+	// allocates nothing
+	int FillPath(T endVertex, DynamicArray<T>* buffer)
+	{
+		DijkstraUntil(endVertex);
+
+		int pathLength = 0;
+
+		for (ReversePathIterator iter = ReversePath(endVertex); !iter.IsFinished(); ++iter)
+			pathLength++;
+
+		if (buffer->GetCapacity() < pathLength)
+			buffer->Resize(pathLength);
+
+		// Path is read from the end, so it is written from the end too
+		int i = pathLength - 1;
+
+		for (ReversePathIterator iter = ReversePath(endVertex); !iter.IsFinished(); ++iter)
+		{
+			buffer->Set(*iter, i);
+			i--;
+		}
+
+		return pathLength;
+	}
+
+	// Path from the end vertex back to the start, without copying it anywhere
+	ReversePathIterator ReversePath(T endVertex)
 	{
-		if (!algorithmStarted)
-			Dijkstra();
+		DijkstraUntil(endVertex);
+
+		if (endVertex != startVertex && !workspace->HasPrev(endVertex))
+			throw vertex_not_found("Vertex was not reached from the start");
 
+		return ReversePathIterator(workspace, startVertex, endVertex);
+	}
+
+	// Path found so far, without continuing the search
+	Sequence<T>* GetTentativePath(T endVertex)
+	{
 		Sequence<T>* path = new ArraySequence<T>();
 
 		T tmp = endVertex;
@@ -117,7 +217,7 @@ public:
 
 		while (tmp != startVertex)
 		{
-			previous = prev->Get(tmp);
+			previous = workspace->GetPrev(tmp);
 
 			path->Append(tmp);
 			tmp = previous;
@@ -140,11 +240,296 @@ public:
 		return path;
 	}
 
-	~DijkstraPathfinder()
+	virtual ~DijkstraPathfinder()
+	{
+		if (ownsWorkspace)
+			delete(workspace);
+	}
+
+	// Checks the closest unchecked vertex and relaxes its edges
+	T CheckNext()
+	{
+		IPriorityQueue<T>* queue = workspace->Queue();
+
+		T v = queue->PopMin();
+
+		workspace->Check(v);
+		checkedCount++;
+
+		int vDistance = workspace->GetDistance(v);
+
+		auto edgeIter = graph->AdjacentIterator(v);
+
+		// For temporarily keeping vertices
+		T tmp;
+
+		//Relaxation
+		for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+		{
+			tmp = (*edgeIter)->GetEnd();
+			int len = (*edgeIter)->GetWeight();
+
+			if (!workspace->IsChecked(tmp) && vDistance + len < workspace->GetDistance(tmp))
+			{
+				int potential = Potential(tmp);
+
+				// Vertex cannot reach the vertex searched for
+				if (potential >= inf)
+					continue;
+
+				workspace->SetDistance(tmp, vDistance + len, v);
+
+				int priority = vDistance + len + potential;
+
+				if (queue->Contains(tmp))
+					queue->DecreasePriority(tmp, priority);
+				else
+					queue->Push(tmp, priority);
+			}
+		}
+
+		return v;
+	}
+
+protected:
+	// Added to the distance when ordering the queue, lets subclasses direct the search.
+	// Must be consistent: potential(u) <= length(u, v) + potential(v) for every edge (u, v),
+	// so that a checked vertex has its final distance (not overestimating is not enough).
+	// Vertices with potential inf cannot reach the vertex searched for, so they are not queued at all
+	virtual int Potential(T vertex)
+	{
+		return 0;
+	}
+
+	// Forgets everything found so far and starts the search from the beginning
+	void Restart()
+	{
+		workspace->Reset();
+		workspace->SetStart(startVertex);
+
+		if (Potential(startVertex) < inf)
+			workspace->Queue()->Push(startVertex, Potential(startVertex));
+
+		checkedCount = 0;
+	}
+};
+
+// Dijkstra algorithm, that checks vertices in order of distance plus
+// heuristic estimate of what is left to the end vertex.
+// Paths stay shortest as long as heuristic is consistent:
+// h(u, end) <= length(u, v) + h(v, end) for every edge (u, v).
+// Heuristic that only never overestimates is not enough, as distances of checked
+// vertices are reused when the end vertex changes
+template<class T>
+class AStarPathfinder : public DijkstraPathfinder<T>
+{
+public:
+	typedef std::function<int(T, T)> Heuristic;
+private:
+	Heuristic heuristic;
+
+	// End vertex the search is currently directed to
+	Optional<T> target;
+public:
+	AStarPathfinder(Graph<T>* graph, T startVertex, Heuristic heuristic,
+		QueueType queueType = QueueType::BINARY_HEAP) :
+		DijkstraPathfinder<T>(graph, startVertex, queueType), heuristic(heuristic)
+	{}
+
+	int GetDistance(T endVertex) override
+	{
+		SetTarget(endVertex);
+
+		return DijkstraPathfinder<T>::GetDistance(endVertex);
+	}
+
+	Sequence<T>* GetPath(T endVertex) override
+	{
+		SetTarget(endVertex);
+
+		return DijkstraPathfinder<T>::GetPath(endVertex);
+	}
+
+	// Queue must be ordered by distance alone, so the search is not directed anywhere
+	Sequence<std::pair<T, int>>* GetWithin(int radius) override
+	{
+		target = Optional<T>();
+
+		return DijkstraPathfinder<T>::GetWithin(radius);
+	}
+
+protected:
+	int Potential(T vertex) override
+	{
+		if (target.HasValue())
+			return heuristic(vertex, *target);
+		else
+			return 0;
+	}
+
+private:
+	// Queue order depends on the end vertex, so search for another one starts over,
+	// unless that vertex is already checked. Its distance is then reused, which is only
+	// right for a consistent heuristic: an admissible one can check vertices too early
+	void SetTarget(T endVertex)
+	{
+		if (target.HasValue() && *target == endVertex)
+			return;
+
+		if (this->IsChecked(endVertex))
+			return;
+
+		target.SetValue(endVertex);
+
+		this->Restart();
+	}
+};
+
+template<class T>
+class BidirectionalDijkstraPathfinder
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	Graph<T>* graph;
+	// Same vertices with reversed edges, for the search from the end vertex
+	Graph<T>* reversedGraph;
+
+	bool ownsReversedGraph;
+
+	T startVertex;
+
+	// Both searches keep their workspaces between end vertices
+	DijkstraPathfinder<T>* forward;
+	DijkstraPathfinder<T>* backward;
+
+	// End vertex of the last search, results are reused while it stays the same
+	Optional<T> endVertex;
+	// Vertex on the shortest path, where both searches met
+	Optional<T> meetingVertex;
+
+	int bestDistance = inf;
+
+public:
+	BidirectionalDijkstraPathfinder(Graph<T>* graph, T startVertex, QueueType queueType = QueueType::BINARY_HEAP) :
+		graph(graph), reversedGraph(graph->Transposed()), ownsReversedGraph(true), startVertex(startVertex),
+		forward(new DijkstraPathfinder<T>(graph, startVertex, queueType)),
+		backward(new DijkstraPathfinder<T>(reversedGraph, startVertex, queueType))
+	{}
+
+	// Reversed graph can be shared by many pathfinders over the same graph
+	BidirectionalDijkstraPathfinder(Graph<T>* graph, Graph<T>* reversedGraph, T startVertex,
+		QueueType queueType = QueueType::BINARY_HEAP) :
+		graph(graph), reversedGraph(reversedGraph), ownsReversedGraph(false), startVertex(startVertex),
+		forward(new DijkstraPathfinder<T>(graph, startVertex, queueType)),
+		backward(new DijkstraPathfinder<T>(reversedGraph, startVertex, queueType))
+	{}
+
+	int GetDistance(T endVertex)
+	{
+		Search(endVertex);
+
+		return bestDistance;
+	}
+
+	Sequence<T>* GetPath(T endVertex)
+	{
+		Search(endVertex);
+
+		if (!meetingVertex.HasValue())
+			throw vertex_not_found("End vertex is unreachable");
+
+		Sequence<T>* path = forward->GetTentativePath(*meetingVertex);
+		Sequence<T>* backwardPath = backward->GetTentativePath(*meetingVertex);
+
+		// Backward path goes from the end vertex to the meeting vertex
+		for (int i = backwardPath->GetLength() - 2; i >= 0; i--)
+		{
+			path->Append(backwardPath->Get(i));
+		}
+
+		delete(backwardPath);
+
+		return path;
+	}
+
+	int CheckedCount()
+	{
+		return forward->CheckedCount() + backward->CheckedCount();
+	}
+
+private:
+	void Search(T end)
+	{
+		if (endVertex.HasValue() && *endVertex == end)
+			return;
+
+		forward->Restart(startVertex);
+		backward->Restart(end);
+
+		endVertex.SetValue(end);
+		meetingVertex = Optional<T>();
+		bestDistance = inf;
+
+		if (startVertex == end)
+		{
+			meetingVertex.SetValue(end);
+			bestDistance = 0;
+			return;
+		}
+
+		// If one of the searches has nothing left, every path it could
+		// take part in was already considered
+		while (forward->HasUnchecked() && backward->HasUnchecked())
+		{
+			int forwardMin = forward->MinUncheckedDistance();
+			int backwardMin = backward->MinUncheckedDistance();
+
+			// No path through unchecked vertices can be shorter
+			if (forwardMin + backwardMin >= bestDistance)
+				break;
+
+			if (forwardMin <= backwardMin)
+				Step(forward, backward, graph);
+			else
+				Step(backward, forward, reversedGraph);
+		}
+	}
+
+	// Checks next vertex of one search and looks for paths through its neighbours,
+	// that were already reached by the other search
+	void Step(DijkstraPathfinder<T>* search, DijkstraPathfinder<T>* other, Graph<T>* searchGraph)
+	{
+		T v = search->CheckNext();
+
+		UpdateBest(v, search, other);
+
+		auto edgeIter = searchGraph->AdjacentIterator(v);
+
+		for (; edgeIter != searchGraph->AdjacentEnd(); ++edgeIter)
+		{
+			UpdateBest((*edgeIter)->GetEnd(), search, other);
+		}
+	}
+
+	void UpdateBest(T vertex, DijkstraPathfinder<T>* search, DijkstraPathfinder<T>* other)
+	{
+		int distance = search->GetTentativeDistance(vertex) + other->GetTentativeDistance(vertex);
+
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			meetingVertex.SetValue(vertex);
+		}
+	}
+
+public:
+	~BidirectionalDijkstraPathfinder()
 	{
-		delete(distances);
-		delete(checked);
-		delete(prev);
+		delete(forward);
+		delete(backward);
+
+		if (ownsReversedGraph)
+			delete(reversedGraph);
 	}
-	
 };
\ No newline at end of file
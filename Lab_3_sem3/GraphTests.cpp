@@ -97,6 +97,108 @@ void topologyGenerationTest()
 
     for (int i = 0; i < 4; i++)
         TestEnvironment::Assert(w5->AreConnected(i, 4));
+
+    Graph<int>* g3x4 = IntegerGraphFactory::Grid(3, 4);
+
+    ASSERT_EQUALS(g3x4->VertexCount(), 12);
+    ASSERT_EQUALS(g3x4->AdjacentCount(0), 2);
+    ASSERT_EQUALS(g3x4->AdjacentCount(4), 4);
+    TestEnvironment::Assert(g3x4->AreConnected(4, 7));
+    TestEnvironment::Assert(!g3x4->AreConnected(2, 3));
+}
+
+// Directed graph with 11 vertices, shortest path from 0 to 10 is 0-8-2-6-7-10 with length 14
+Graph<int>* createPathfindingGraph()
+{
+    Graph<int>* g = IntegerGraphFactory::Empty(11);
+
+    g->SetBidirectionalEdge(0, 1, 1);
+    g->SetBidirectionalEdge(2, 8, 3);
+    g->SetBidirectionalEdge(2, 3, 10);
+    g->SetBidirectionalEdge(2, 7, 16);
+    g->SetBidirectionalEdge(3, 5, 7);
+    g->SetBidirectionalEdge(5, 10, 5);
+    g->SetBidirectionalEdge(4, 5, 6);
+    g->SetBidirectionalEdge(4, 6, 1);
+    g->SetBidirectionalEdge(5, 6, 9);
+    g->SetBidirectionalEdge(7, 10, 2);
+
+    g->SetAdjacent(0, 8, 3);
+    g->SetAdjacent(1, 9, 7);
+    g->SetAdjacent(1, 3, 10);
+    g->SetAdjacent(9, 10, 11);
+    g->SetAdjacent(3, 10, 9);
+    g->SetAdjacent(2, 6, 5);
+    g->SetAdjacent(6, 7, 1);
+
+    return g;
+}
+
+// Checks that path starts and ends where it should and its edges add up to expected length
+void assertPathLength(Graph<int>* g, Sequence<int>* path, int start, int end, int expectedLength)
+{
+    ASSERT_EQUALS(path->GetFirst(), start);
+    ASSERT_EQUALS(path->GetLast(), end);
+
+    int length = 0;
+
+    for (int i = 0; i < path->GetLength() - 1; i++)
+        length += g->EdgeLength(path->Get(i), path->Get(i + 1));
+
+    ASSERT_EQUALS(length, expectedLength);
+}
+
+void testPriorityQueues()
+{
+    // Bucket queue starts smaller than the spread of priorities, so it has to grow
+    IPriorityQueue<int>* queues[] = { new BinaryHeap<int>(intHash), new LinearSearchQueue<int>(intHash),
+        new BucketQueue<int>(intHash, 8), new IndexHeap(100) };
+
+    for (IPriorityQueue<int>* q : queues)
+    {
+        for (int i = 0; i < 100; i++)
+            q->Push(i, (i * 37) % 101);
+
+        ASSERT_THROWS(q->Push(5, 1), std::invalid_argument);
+
+        q->DecreasePriority(50, -1);
+
+        ASSERT_EQUALS(q->Count(), 100);
+        ASSERT_EQUALS(q->MinPriority(), -1);
+        ASSERT_EQUALS(q->PopMin(), 50);
+
+        int last = q->MinPriority();
+
+        while (!q->IsEmpty())
+        {
+            TestEnvironment::Assert(q->MinPriority() >= last);
+
+            last = q->MinPriority();
+            q->PopMin();
+        }
+
+        ASSERT_THROWS(q->PopMin(), std::out_of_range);
+
+        // Cleared queue forgets items left in it, and works as a new one
+        for (int i = 0; i < 20; i++)
+            q->Push(i, i % 7 + 10);
+
+        q->DecreasePriority(3, 2);
+        q->PopMin();
+        q->Clear();
+
+        ASSERT_EQUALS(q->Count(), 0);
+        TestEnvironment::Assert(q->IsEmpty() && !q->Contains(5));
+
+        q->Push(5, 30);
+        q->Push(3, 20);
+
+        ASSERT_EQUALS(q->PopMin(), 3);
+        ASSERT_EQUALS(q->PopMin(), 5);
+        TestEnvironment::Assert(q->IsEmpty());
+
+        delete(q);
+    }
 }
 
 void testDijkstra() {
@@ -108,32 +210,379 @@ void testDijkstra() {
 
     p.GetPath(4);
 
-    Graph<int>* g1 = IntegerGraphFactory::Empty(11);
-
-    g1->SetBidirectionalEdge(0, 1, 1);
-    g1->SetBidirectionalEdge(2, 8, 3);
-    g1->SetBidirectionalEdge(2, 3, 10);
-    g1->SetBidirectionalEdge(2, 7, 16);
-    g1->SetBidirectionalEdge(3, 5, 7);
-    g1->SetBidirectionalEdge(5, 10, 5);
-    g1->SetBidirectionalEdge(4, 5, 6);
-    g1->SetBidirectionalEdge(4, 6, 1);
-    g1->SetBidirectionalEdge(5, 6, 9);
-    g1->SetBidirectionalEdge(7, 10, 2);
-
-    g1->SetAdjacent(0, 8, 3);
-    g1->SetAdjacent(1, 9, 7);
-    g1->SetAdjacent(1, 3, 10);
-    g1->SetAdjacent(9, 10, 11);
-    g1->SetAdjacent(3, 10, 9);
-    g1->SetAdjacent(2, 6, 5);
-    g1->SetAdjacent(6, 7, 1);
+    Graph<int>* g1 = createPathfindingGraph();
 
     DijkstraPathfinder<int>* p1 = new DijkstraPathfinder<int>(g1, 0);
 
     AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p1->GetPath(10));
     ASSERT_EQUALS(14, p1->GetDistance(10))
 
+    DijkstraPathfinder<int>* p2 = new DijkstraPathfinder<int>(g1, 0, QueueType::LINEAR_SEARCH);
+
+    for (int i = 0; i < 11; i++)
+        ASSERT_EQUALS(p1->GetDistance(i), p2->GetDistance(i));
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p2->GetPath(10));
+
+    Graph<int>* p100 = IntegerGraphFactory::Chain(100, 2);
+
+    DijkstraPathfinder<int>* p3 = new DijkstraPathfinder<int>(p100, 10);
+
+    ASSERT_EQUALS(p3->GetDistance(13), 6);
+    TestEnvironment::Assert(p3->CheckedCount() < 10);
+
+    ASSERT_EQUALS(p3->GetDistance(60), 100);
+    TestEnvironment::Assert(!p3->IsChecked(90));
+
+    int checkedBefore = p3->CheckedCount();
+
+    AssertSequenceEquals({ 10, 9, 8 }, p3->GetPath(8));
+    ASSERT_EQUALS(p3->CheckedCount(), checkedBefore);
+
+    p3->Dijkstra();
+
+    ASSERT_EQUALS(p3->CheckedCount(), 100);
+    ASSERT_EQUALS(p3->GetDistance(99), 178);
+    ASSERT_THROWS(p3->GetDistance(100), vertex_not_found);
+
+    PathfinderWorkspace<int>* workspace = new PathfinderWorkspace<int>(intHash);
+
+    for (int start = 0; start < 11; start++)
+    {
+        DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(g1, start);
+        DijkstraPathfinder<int>* actual = new DijkstraPathfinder<int>(g1, start, workspace);
+
+        for (int end = 10; end >= 0; end--)
+            ASSERT_EQUALS(actual->GetDistance(end), expected->GetDistance(end));
+
+        delete(expected);
+        delete(actual);
+    }
+
+    p1->Restart(2);
+
+    AssertSequenceEquals({ 2, 6, 7, 10 }, p1->GetPath(10));
+    ASSERT_EQUALS(p1->GetDistance(0), DijkstraPathfinder<int>::inf);
+
+    DijkstraPathfinder<int>* p4 = new DijkstraPathfinder<int>(g1, 0, QueueType::BUCKETS);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p4->GetPath(10));
+
+    for (int start = 0; start < 11; start++)
+    {
+        p2->Restart(start);
+        p4->Restart(start);
+
+        for (int end = 0; end < 11; end++)
+            ASSERT_EQUALS(p4->GetDistance(end), p2->GetDistance(end));
+    }
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(20, 20, 3);
+
+    DijkstraPathfinder<int>* p5 = new DijkstraPathfinder<int>(grid, 0, QueueType::AUTO);
+
+    ASSERT_EQUALS(p5->GetDistance(399), 114);
+    ASSERT_EQUALS(p5->GetPath(399)->GetLength(), 39);
+
+    // Vertices at most two steps away from the corner
+    Sequence<std::pair<int, int>>* within = p5->GetWithin(6);
+
+    ASSERT_EQUALS(within->GetLength(), 6);
+    ASSERT_EQUALS(p5->CheckedCount(), 6);
+
+    for (int i = 0; i < within->GetLength(); i++)
+    {
+        int v = within->Get(i).first;
+
+        ASSERT_EQUALS(within->Get(i).second, 3 * (v % 20 + v / 20));
+        TestEnvironment::Assert(i == 0 || within->Get(i - 1).second <= within->Get(i).second);
+    }
+
+    ASSERT_EQUALS(p5->GetDistance(399), 114);
+    ASSERT_EQUALS(p1->GetWithin(-1)->GetLength(), 0);
+    ASSERT_EQUALS(p1->GetWithin(8)->GetLength(), 6);
+
+    // Buffer is too short for the first path and has to grow once
+    DynamicArray<int>* buffer = new DynamicArray<int>(2);
+
+    p2->Restart(0);
+
+    ASSERT_EQUALS(p2->FillPath(10, buffer), 6);
+
+    int expectedPath[] = { 0, 8, 2, 6, 7, 10 };
+
+    for (int i = 0; i < 6; i++)
+        ASSERT_EQUALS(buffer->Get(i), expectedPath[i]);
+
+    ASSERT_EQUALS(p2->FillPath(0, buffer), 1);
+    ASSERT_EQUALS(buffer->Get(0), 0);
+
+    int i = 5;
+
+    for (auto iter = p2->ReversePath(10); !iter.IsFinished(); ++iter)
+    {
+        ASSERT_EQUALS(*iter, expectedPath[i]);
+        i--;
+    }
+
+    ASSERT_EQUALS(i, -1);
+
+    p2->Restart(2);
+
+    ASSERT_THROWS(p2->ReversePath(0), vertex_not_found);
+
+    delete(buffer);
+    delete(workspace);
+}
+
+void testContractionHierarchy()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    ContractionHierarchy<int>* hierarchy = new ContractionHierarchy<int>(g);
+
+    ContractionHierarchyPathfinder<int>* p = new ContractionHierarchyPathfinder<int>(hierarchy, 0);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p->GetPath(10));
+    ASSERT_EQUALS(p->GetDistance(10), 14);
+    ASSERT_EQUALS(p->GetDistance(0), 0);
+    AssertSequenceEquals({ 0 }, p->GetPath(0));
+    ASSERT_THROWS(p->GetDistance(11), vertex_not_found);
+
+    DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(g, 0);
+
+    for (int start = 0; start < 11; start++)
+    {
+        expected->Restart(start);
+        p->Restart(start);
+
+        for (int end = 0; end < 11; end++)
+        {
+            ASSERT_EQUALS(p->GetDistance(end), expected->GetDistance(end));
+
+            if (expected->GetDistance(end) < DijkstraPathfinder<int>::inf)
+                assertPathLength(g, p->GetPath(end), start, end, expected->GetDistance(end));
+            else
+                ASSERT_THROWS(p->GetPath(end), vertex_not_found);
+        }
+    }
+
+    // Grid with varying weights, so that shortcuts are unpacked through several levels
+    const int width = 15;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    for (int v = 0; v + 1 < width * width; v++)
+        if ((v + 1) % width != 0)
+            grid->SetAdjacent(v, v + 1, (v * 7) % 13 + 1);
+
+    ContractionHierarchy<int>* gridHierarchy = new ContractionHierarchy<int>(grid);
+    ContractionHierarchyPathfinder<int>* p1 = new ContractionHierarchyPathfinder<int>(gridHierarchy, 0);
+
+    TestEnvironment::Assert(gridHierarchy->ShortcutCount() > 0);
+
+    int starts[] = { 0, 7, 112, 224 };
+
+    for (int start : starts)
+    {
+        expected = new DijkstraPathfinder<int>(grid, start);
+        p1->Restart(start);
+
+        for (int end = 0; end < width * width; end += 4)
+        {
+            ASSERT_EQUALS(p1->GetDistance(end), expected->GetDistance(end));
+            assertPathLength(grid, p1->GetPath(end), start, end, expected->GetDistance(end));
+        }
+
+        delete(expected);
+    }
+
+    delete(p);
+    delete(p1);
+    delete(hierarchy);
+    delete(gridHierarchy);
+}
+
+void testShortestPathCache()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    int version = g->Version();
+
+    ShortestPathCache<int>* cache = new ShortestPathCache<int>(g, 2);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, cache->GetPath(0, 10));
+    ASSERT_EQUALS(cache->GetDistance(0, 10), 14);
+    ASSERT_EQUALS(cache->GetDistance(2, 10), 8);
+    ASSERT_EQUALS(cache->GetDistance(0, 5), 18);
+
+    ASSERT_EQUALS(cache->MissCount(), 2);
+    ASSERT_EQUALS(cache->HitCount(), 2);
+
+    // Start 2 was used the longest time ago, so it is the one thrown away
+    ASSERT_EQUALS(cache->GetDistance(4, 5), 6);
+    ASSERT_EQUALS(cache->Count(), 2);
+    ASSERT_EQUALS(cache->GetDistance(0, 7), 12);
+    ASSERT_EQUALS(cache->MissCount(), 3);
+
+    ASSERT_THROWS(cache->GetDistance(11, 0), vertex_not_found);
+
+    g->SetAdjacent(8, 10, 1);
+
+    TestEnvironment::Assert(g->Version() != version);
+
+    AssertSequenceEquals({ 0, 8, 10 }, cache->GetPath(0, 10));
+    ASSERT_EQUALS(cache->GetDistance(0, 10), 4);
+    ASSERT_EQUALS(cache->Count(), 1);
+
+    version = g->Version();
+
+    g->RemoveVertex(8);
+
+    TestEnvironment::Assert(g->Version() != version);
+    ASSERT_EQUALS(cache->GetDistance(0, 10), 19);
+
+    delete(cache);
+    delete(g);
+}
+
+void testDynamicPathfinder()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    DynamicPathfinder<int>* p = new DynamicPathfinder<int>(g, 0);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p->GetPath(10));
+    ASSERT_EQUALS(p->GetDistance(10), 14);
+
+    p->SetAdjacent(8, 10, 1);
+
+    AssertSequenceEquals({ 0, 8, 10 }, p->GetPath(10));
+    ASSERT_EQUALS(p->GetDistance(10), 4);
+    // Only 10 and the vertices it brought closer, 5 and 7, are checked again
+    ASSERT_EQUALS(p->CheckedCount(), 3);
+
+    p->RemoveAdjacent(8, 10);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p->GetPath(10));
+
+    // Changes made directly in the graph are noticed too
+    g->SetAdjacent(0, 8, 30);
+
+    ASSERT_EQUALS(p->GetDistance(8), 24);
+
+    // Grid with varying weights, compared to a new search after every change
+    const int width = 12;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    DynamicPathfinder<int>* p1 = new DynamicPathfinder<int>(grid, 0);
+
+    for (int i = 0; i < 200; i++)
+    {
+        int from = (i * 37) % (width * width);
+        int to = (i % 2 == 0) ? from + 1 : from + width;
+
+        if (to >= width * width || (i % 2 == 0 && to % width == 0))
+            continue;
+
+        if (i % 7 == 0)
+            p1->RemoveAdjacent(from, to);
+        else
+            p1->SetAdjacent(from, to, (i * 13) % 9 + 1);
+
+        DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(grid, 0);
+
+        for (int end = 0; end < width * width; end += 5)
+            ASSERT_EQUALS(p1->GetDistance(end), expected->GetDistance(end));
+
+        delete(expected);
+    }
+
+    delete(p);
+    delete(p1);
+}
+
+// Network with 9 vertices and maximum stream of 10 from 0 to 8
+Graph<int>* createStreamGraph()
+{
+    Graph<int>* g = IntegerGraphFactory::Empty(9);
+
+    g->SetBidirectionalEdge(2, 3, 1);
+    g->SetBidirectionalEdge(3, 4, 3);
+    g->SetBidirectionalEdge(4, 5, 2);
+    g->SetBidirectionalEdge(4, 6, 9);
+    g->SetBidirectionalEdge(5, 6, 5);
+
+    g->SetAdjacent(0, 1, 5);
+    g->SetAdjacent(0, 5, 11);
+    g->SetAdjacent(1, 2, 2);
+    g->SetAdjacent(1, 3, 1);
+    g->SetAdjacent(2, 7, 4);
+    g->SetAdjacent(3, 7, 3);
+    g->SetAdjacent(6, 8, 4);
+    g->SetAdjacent(7, 8, 12);
+
+    return g;
+}
+
+// Checks that stream through every edge fits its capacity and every vertex but the ends
+// lets through all it gets
+void assertValidStreams(Graph<int>* g, Graph<int>* streams, int start, int end, int expectedStream)
+{
+    for (auto vertexIter = streams->begin(); vertexIter != streams->end(); ++vertexIter)
+    {
+        int v = (*vertexIter).first;
+        int outflow = 0;
+
+        for (auto iter = streams->AdjacentIterator(v); iter != streams->AdjacentEnd(); ++iter)
+        {
+            int stream = (*iter)->GetWeight();
+
+            ASSERT_EQUALS(streams->EdgeLength((*iter)->GetEnd(), v), -stream);
+
+            if (stream > 0)
+                TestEnvironment::Assert(stream <= g->EdgeLength(v, (*iter)->GetEnd()));
+
+            outflow += stream;
+        }
+
+        if (v == start)
+            ASSERT_EQUALS(outflow, expectedStream)
+        else if (v == end)
+            ASSERT_EQUALS(outflow, -expectedStream)
+        else
+            ASSERT_EQUALS(outflow, 0)
+    }
+}
+
+// Same checks on the flat per-edge result: every stream fits its edge,
+// and every vertex but the ends lets through all it gets
+void assertValidEdgeStreams(Graph<int>* g, EdgeStreams<int>* streams, int start, int end, int expectedStream)
+{
+    int edgeCount = 0;
+
+    for (auto vertexIter = g->begin(); vertexIter != g->end(); ++vertexIter)
+        edgeCount += g->AdjacentCount((*vertexIter).first);
+
+    ASSERT_EQUALS(streams->Count(), edgeCount);
+
+    DynamicArray<int> outflows(g->VertexCount());
+
+    for (int v = 0; v < g->VertexCount(); v++)
+        outflows.Set(0, v);
+
+    for (auto stream : *streams)
+    {
+        TestEnvironment::Assert(stream.GetStream() >= 0);
+        TestEnvironment::Assert(stream.GetStream() <= g->EdgeLength(stream.GetStart(), stream.GetEnd()));
+
+        outflows.Set(outflows.Get(stream.GetStart()) + stream.GetStream(), stream.GetStart());
+        outflows.Set(outflows.Get(stream.GetEnd()) - stream.GetStream(), stream.GetEnd());
+    }
+
+    for (int v = 0; v < g->VertexCount(); v++)
+        ASSERT_EQUALS(outflows.Get(v), v == start ? expectedStream : v == end ? -expectedStream : 0);
 }
 
 void testEdmondsKarp()
@@ -144,24 +593,922 @@ void testEdmondsKarp()
 
     ASSERT_EQUALS(f->FindStream(), 3);
 
-    Graph<int>* g1 = IntegerGraphFactory::Empty(9);
+    Graph<int>* g1 = createStreamGraph();
+
+    EdmondsKarpStreamFinder<int>* f1 = new EdmondsKarpStreamFinder<int>(g1, 0, 8);
+
+    ASSERT_EQUALS(f1->FindStream(), 10);
 
-    g1->SetBidirectionalEdge(2, 3, 1);
-    g1->SetBidirectionalEdge(3, 4, 3);
-    g1->SetBidirectionalEdge(4, 5, 2);
-    g1->SetBidirectionalEdge(4, 6, 9);
-    g1->SetBidirectionalEdge(5, 6, 5);
+    assertValidStreams(g1, f1->GetStreams(), 0, 8, 10);
 
-    g1->SetAdjacent(0, 1, 5);
-    g1->SetAdjacent(0, 5, 11);
-    g1->SetAdjacent(1, 2, 2);
-    g1->SetAdjacent(1, 3, 1);
-    g1->SetAdjacent(2, 7, 4);
-    g1->SetAdjacent(3, 7, 3);
-    g1->SetAdjacent(6, 8, 4);
-    g1->SetAdjacent(7, 8, 12);
+    ResidualNetwork<int>* network = new ResidualNetwork<int>(g1);
 
-    EdmondsKarpStreamFinder<int>* f1 = new EdmondsKarpStreamFinder<int>(g1, 0, 8);
+    ASSERT_EQUALS(network->VertexCount(), 9);
+    ASSERT_EQUALS(network->ArcCount(), 36);
+
+    int arc = network->ArcsBegin(network->IndexOf(0));
+
+    network->Push(arc, 2);
+
+    ASSERT_EQUALS(network->Flow(network->Pair(arc)), -2);
+    ASSERT_EQUALS(network->Residual(network->Pair(arc)), 2);
+    ASSERT_EQUALS(network->Outflow(network->IndexOf(0)), 2);
+    ASSERT_EQUALS(network->ArcStart(arc), network->IndexOf(0));
+
+    // Shortest path with free capacity is 0-5-6-8, and edge 6-8 is the narrowest
+    AugmentingPathFinder<int>* paths = new AugmentingPathFinder<int>(network);
+
+    TestEnvironment::Assert(paths->Find(network->IndexOf(0), network->IndexOf(8)));
+
+    int arcCount = 0;
+
+    for (int a = paths->PathArc(network->IndexOf(8)); a != -1; a = paths->PathArc(network->ArcStart(a)))
+        arcCount++;
+
+    ASSERT_EQUALS(arcCount, 3);
+    ASSERT_EQUALS(paths->Augment(network->IndexOf(8)), 4);
+    ASSERT_EQUALS(network->Outflow(network->IndexOf(8)), -4);
+
+    delete(f);
+    delete(f1);
+    delete(paths);
+    delete(network);
+}
+
+void testCapacityScaling()
+{
+    Graph<int>* g = createStreamGraph();
+
+    IStreamFinder<int>* f = new CapacityScalingStreamFinder<int>(g, 0, 8);
+
+    ASSERT_EQUALS(f->FindStream(), 10);
+    assertValidStreams(g, f->GetStreams(), 0, 8, 10);
+
+    // Capacities from 1 to 100000
+    const int size = 30;
+
+    Graph<int>* complete = IntegerGraphFactory::Complete(size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            if (i != j)
+            {
+                int capacity = 1;
+
+                for (int k = (i * 7 + j * 3) % 6; k > 0; k--)
+                    capacity *= 10;
+
+                complete->SetAdjacent(i, j, capacity);
+            }
+
+    for (int end = 1; end < size; end += 5)
+    {
+        IStreamFinder<int>* expected = new DinicStreamFinder<int>(complete, 0, end);
+        IStreamFinder<int>* actual = new CapacityScalingStreamFinder<int>(complete, 0, end);
+
+        int stream = expected->FindStream();
+
+        ASSERT_EQUALS(actual->FindStream(), stream);
+        assertValidStreams(complete, actual->GetStreams(), 0, end, stream);
+
+        delete(expected);
+        delete(actual);
+    }
+
+    delete(f);
+}
+
+void testDinic()
+{
+    Graph<int>* g = IntegerGraphFactory::Wheel(6, 2, 1, Direction::CLOCKWISE);
+
+    DinicStreamFinder<int>* f = new DinicStreamFinder<int>(g, 0, 3);
+
+    ASSERT_EQUALS(f->FindStream(), 3);
+
+    Graph<int>* g1 = createStreamGraph();
+
+    DinicStreamFinder<int>* f1 = new DinicStreamFinder<int>(g1, 0, 8);
 
     ASSERT_EQUALS(f1->FindStream(), 10);
+    ASSERT_EQUALS(f1->GetStreams()->EdgeLength(0, 5), 7);
+
+    // Grid with unit capacities and capacities of 2 mixed, compared to Edmonds-Karp
+    const int width = 12;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    for (int v = 0; v < width * width; v += 3)
+        if (v + width < width * width)
+            grid->SetAdjacent(v, v + width, 2);
+
+    int ends[][2] = { { 0, width * width - 1 }, { 5, 7 * width }, { width - 1, width * (width - 1) } };
+
+    for (auto& pair : ends)
+    {
+        EdmondsKarpStreamFinder<int>* expected = new EdmondsKarpStreamFinder<int>(grid, pair[0], pair[1]);
+        DinicStreamFinder<int>* actual = new DinicStreamFinder<int>(grid, pair[0], pair[1]);
+
+        ASSERT_EQUALS(actual->FindStream(), expected->FindStream());
+
+        delete(expected);
+        delete(actual);
+    }
+
+    ASSERT_THROWS(new DinicStreamFinder<int>(g1, 2, 2), std::invalid_argument);
+
+    delete(f);
+    delete(f1);
+}
+
+void testPushRelabel()
+{
+    Graph<int>* g = IntegerGraphFactory::Wheel(6, 2, 1, Direction::CLOCKWISE);
+
+    IStreamFinder<int>* f = new PushRelabelStreamFinder<int>(g, 0, 3);
+
+    ASSERT_EQUALS(f->FindStream(), 3);
+
+    Graph<int>* g1 = createStreamGraph();
+
+    IStreamFinder<int>* f1 = new PushRelabelStreamFinder<int>(g1, 0, 8);
+
+    ASSERT_EQUALS(f1->FindStream(), 10);
+    assertValidStreams(g1, f1->GetStreams(), 0, 8, 10);
+
+    // Dense network with capacities of very different size, where some excess
+    // has to go back to the start
+    const int size = 40;
+
+    Graph<int>* complete = IntegerGraphFactory::Complete(size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            if (i != j)
+                complete->SetAdjacent(i, j, (i * 31 + j * 17) % 97 + 1);
+
+    for (int end = 1; end < size; end += 6)
+    {
+        IStreamFinder<int>* expected = new DinicStreamFinder<int>(complete, 0, end);
+        IStreamFinder<int>* actual = new PushRelabelStreamFinder<int>(complete, 0, end);
+
+        int stream = expected->FindStream();
+
+        ASSERT_EQUALS(actual->FindStream(), stream);
+        assertValidStreams(complete, actual->GetStreams(), 0, end, stream);
+
+        delete(expected);
+        delete(actual);
+    }
+
+    const int width = 12;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    for (int v = 0; v < width * width; v += 3)
+        if (v + width < width * width)
+            grid->SetAdjacent(v, v + width, 2);
+
+    IStreamFinder<int>* expected = new EdmondsKarpStreamFinder<int>(grid, 5, 7 * width);
+    IStreamFinder<int>* actual = new PushRelabelStreamFinder<int>(grid, 5, 7 * width);
+
+    ASSERT_EQUALS(actual->FindStream(), expected->FindStream());
+
+    // Layers joined by wide edges and a narrow way to the end, so most of the excess
+    // goes back to the start, and labels of whole layers get emptied (gaps)
+    const int layers = 10;
+    const int layerSize = 20;
+
+    Graph<int>* layered = IntegerGraphFactory::Empty(layers * layerSize + 2);
+
+    int source = layers * layerSize;
+    int sink = source + 1;
+
+    for (int i = 0; i < layerSize; i++)
+    {
+        layered->SetAdjacent(source, i, 50);
+        layered->SetAdjacent((layers - 1) * layerSize + i, sink, i % 3);
+    }
+
+    for (int layer = 0; layer + 1 < layers; layer++)
+        for (int i = 0; i < layerSize; i++)
+            for (int j = 0; j < layerSize; j++)
+                layered->SetAdjacent(layer * layerSize + i, (layer + 1) * layerSize + j, (i + j) % 4 + 1);
+
+    IStreamFinder<int>* layeredExpected = new DinicStreamFinder<int>(layered, source, sink);
+    IStreamFinder<int>* layeredActual = new PushRelabelStreamFinder<int>(layered, source, sink);
+
+    int stream = layeredExpected->FindStream();
+
+    ASSERT_EQUALS(layeredActual->FindStream(), stream);
+    assertValidStreams(layered, layeredActual->GetStreams(), source, sink, stream);
+
+    delete(f);
+    delete(f1);
+    delete(expected);
+    delete(actual);
+    delete(layeredExpected);
+    delete(layeredActual);
+}
+
+void testParallelPushRelabel()
+{
+    Graph<int>* g = createStreamGraph();
+
+    IStreamFinder<int>* f = new ParallelPushRelabelStreamFinder<int>(g, 0, 8, 4);
+
+    ASSERT_EQUALS(f->FindStream(), 10);
+    assertValidStreams(g, f->GetStreams(), 0, 8, 10);
+
+    // Enough vertices get excess from the start, so rounds run on several threads
+    const int size = 150;
+
+    Graph<int>* complete = IntegerGraphFactory::Complete(size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            if (i != j)
+                complete->SetAdjacent(i, j, (i * 31 + j * 17) % 97 + 1);
+
+    for (int end = 1; end < size; end += 37)
+    {
+        IStreamFinder<int>* expected = new DinicStreamFinder<int>(complete, 0, end);
+        IStreamFinder<int>* actual = new ParallelPushRelabelStreamFinder<int>(complete, 0, end, 4);
+
+        int stream = expected->FindStream();
+
+        ASSERT_EQUALS(actual->FindStream(), stream);
+        assertValidStreams(complete, actual->GetStreams(), 0, end, stream);
+
+        delete(expected);
+        delete(actual);
+    }
+
+    const int width = 20;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    for (int v = 0; v < width * width; v += 3)
+        if (v + width < width * width)
+            grid->SetAdjacent(v, v + width, 2);
+
+    IStreamFinder<int>* expected = new DinicStreamFinder<int>(grid, 5, 17 * width);
+    IStreamFinder<int>* actual = new ParallelPushRelabelStreamFinder<int>(grid, 5, 17 * width, 4);
+
+    int stream = expected->FindStream();
+
+    ASSERT_EQUALS(actual->FindStream(), stream);
+    assertValidStreams(grid, actual->GetStreams(), 5, 17 * width, stream);
+
+    // Wide layers, so that every round has more active vertices than one thread takes,
+    // and most of the excess has to go back to the start
+    const int layers = 6;
+    const int layerSize = 200;
+
+    Graph<int>* layered = IntegerGraphFactory::Empty(layers * layerSize + 2);
+
+    int source = layers * layerSize;
+    int sink = source + 1;
+
+    for (int i = 0; i < layerSize; i++)
+    {
+        layered->SetAdjacent(source, i, 40);
+        layered->SetAdjacent((layers - 1) * layerSize + i, sink, i % 5);
+    }
+
+    for (int layer = 0; layer + 1 < layers; layer++)
+        for (int i = 0; i < layerSize; i++)
+            for (int j = i; j < i + 8; j++)
+                layered->SetAdjacent(layer * layerSize + i, (layer + 1) * layerSize + j % layerSize, (i * 3 + j) % 7 + 1);
+
+    ThreadPool* pool = new ThreadPool();
+
+    IStreamFinder<int>* layeredExpected = new DinicStreamFinder<int>(layered, source, sink);
+    IStreamFinder<int>* layeredActual = new ParallelPushRelabelStreamFinder<int>(layered, source, sink, 4, pool);
+
+    // Workers are started with the finder, not during the search
+    ASSERT_EQUALS(pool->WorkerCount(), 3);
+
+    stream = layeredExpected->FindStream();
+
+    ASSERT_EQUALS(layeredActual->FindStream(), stream);
+
+    EdgeStreams<int>* edgeStreams = layeredActual->GetEdgeStreams();
+
+    assertValidEdgeStreams(layered, edgeStreams, source, sink, stream);
+
+    delete(f);
+    delete(expected);
+    delete(actual);
+    delete(edgeStreams);
+    delete(layeredExpected);
+    delete(layeredActual);
+    delete(pool);
+}
+
+void testEdgeStreams()
+{
+    Graph<int>* g = createStreamGraph();
+
+    IStreamFinder<int>* f = new DinicStreamFinder<int>(g, 0, 8);
+
+    EdgeStreams<int>* streams = f->GetEdgeStreams();
+
+    ASSERT_EQUALS(streams->Count(), 18);
+
+    // Edges go in the same order as the graph lists them
+    int edge = 0;
+
+    for (auto vertexIter = g->begin(); vertexIter != g->end(); ++vertexIter)
+    {
+        int v = (*vertexIter).first;
+
+        for (auto iter = g->AdjacentIterator(v); iter != g->AdjacentEnd(); ++iter)
+        {
+            ASSERT_EQUALS(streams->StartAt(edge), v);
+            ASSERT_EQUALS(streams->EndAt(edge), (*iter)->GetEnd());
+
+            edge++;
+        }
+    }
+
+    DynamicArray<int> outflows(g->VertexCount());
+
+    for (int v = 0; v < g->VertexCount(); v++)
+        outflows.Set(0, v);
+
+    for (auto stream : *streams)
+    {
+        TestEnvironment::Assert(stream.GetStream() >= 0);
+        TestEnvironment::Assert(stream.GetStream() <= g->EdgeLength(stream.GetStart(), stream.GetEnd()));
+
+        outflows.Set(outflows.Get(stream.GetStart()) + stream.GetStream(), stream.GetStart());
+        outflows.Set(outflows.Get(stream.GetEnd()) - stream.GetStream(), stream.GetEnd());
+    }
+
+    for (int v = 0; v < g->VertexCount(); v++)
+        ASSERT_EQUALS(outflows.Get(v), v == 0 ? 10 : v == 8 ? -10 : 0);
+
+    // Edges with no opposite one have the same stream in the graph of streams
+    Graph<int>* streamGraph = f->GetStreams();
+
+    for (int i = 0; i < streams->Count(); i++)
+        if (!g->AreConnected(streams->EndAt(i), streams->StartAt(i)))
+            ASSERT_EQUALS(streamGraph->EdgeLength(streams->StartAt(i), streams->EndAt(i)), streams->StreamAt(i));
+
+    delete(streams);
+    delete(f);
+}
+
+void testWarmStartedStream()
+{
+    Graph<int>* g = createStreamGraph();
+
+    EdmondsKarpStreamFinder<int>* f = new EdmondsKarpStreamFinder<int>(g, 0, 8);
+
+    ASSERT_EQUALS(f->FindStream(), 10);
+
+    // Edge to the end fails, its flow goes back to the start
+    f->SetCapacity(6, 8, 1);
+
+    ASSERT_EQUALS(f->FindStream(), 7);
+    assertValidStreams(g, f->GetStreams(), 0, 8, 7);
+
+    // Edge in the middle fails, while the one to the end gets more than before
+    f->SetCapacity(6, 8, 10);
+    f->SetCapacity(4, 3, 0);
+
+    IStreamFinder<int>* expected = new DinicStreamFinder<int>(g, 0, 8);
+
+    ASSERT_EQUALS(f->FindStream(), expected->FindStream());
+    assertValidStreams(g, f->GetStreams(), 0, 8, expected->FindStream());
+
+    ASSERT_THROWS(f->SetCapacity(0, 8, 3), vertex_not_found);
+    ASSERT_THROWS(f->SetCapacity(0, 1, -1), std::invalid_argument);
+
+    const int width = 12;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    for (int v = 0; v < width * width; v += 3)
+        if (v + width < width * width)
+            grid->SetAdjacent(v, v + width, 2);
+
+    EdmondsKarpStreamFinder<int>* warm = new EdmondsKarpStreamFinder<int>(grid, 5, 7 * width);
+
+    warm->FindStream();
+
+    // Every change is checked against a search from zero flow
+    for (int i = 0; i < 40; i++)
+    {
+        int v = (i * 37) % (width * width - width);
+        int capacity = (i * 13) % 5;
+
+        warm->SetCapacity(v, v + width, capacity);
+
+        IStreamFinder<int>* cold = new DinicStreamFinder<int>(grid, 5, 7 * width);
+
+        int stream = cold->FindStream();
+
+        ASSERT_EQUALS(warm->FindStream(), stream);
+        assertValidStreams(grid, warm->GetStreams(), 5, 7 * width, stream);
+
+        delete(cold);
+    }
+
+    delete(f);
+    delete(expected);
+    delete(warm);
+}
+
+void testGomoryHuTree()
+{
+    Graph<int>* g = IntegerGraphFactory::Empty(4);
+
+    g->SetBidirectionalEdge(0, 1, 3);
+    g->SetBidirectionalEdge(1, 2, 5);
+
+    GomoryHuTree<int>* tree = new GomoryHuTree<int>(g);
+
+    ASSERT_EQUALS(tree->GetStream(0, 2), 3);
+    ASSERT_EQUALS(tree->GetStream(2, 1), 5);
+    // Vertex 3 has no edges
+    ASSERT_EQUALS(tree->GetStream(3, 1), 0);
+    ASSERT_EQUALS(tree->ParentCapacity(tree->Parent(0)), 0);
+    ASSERT_THROWS(tree->GetStream(1, 1), std::invalid_argument);
+
+    // Sparse undirected network, every pair is checked against a search of its own
+    const int size = 14;
+
+    Graph<int>* network = IntegerGraphFactory::Empty(size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = i + 1; j < size; j++)
+            if ((i * 7 + j * 3) % 4 == 0)
+                network->SetBidirectionalEdge(i, j, (i * 31 + j * 17) % 23 + 1);
+
+    GomoryHuTree<int>* tree1 = new GomoryHuTree<int>(network);
+
+    ASSERT_EQUALS(tree1->VertexCount(), size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = i + 1; j < size; j++)
+        {
+            IStreamFinder<int>* expected = new DinicStreamFinder<int>(network, i, j);
+
+            int stream = expected->FindStream();
+
+            ASSERT_EQUALS(tree1->GetStream(i, j), stream);
+            ASSERT_EQUALS(tree1->GetStream(j, i), stream);
+
+            delete(expected);
+        }
+
+    delete(tree);
+    delete(tree1);
+}
+
+// Checks that the cut separates the ends, its edges are full and add up to the stream
+void assertValidMinCut(Graph<int>* g, IStreamFinder<int>* finder, int start, int end)
+{
+    int stream = finder->FindStream();
+    Graph<int>* streams = finder->GetStreams();
+    MinCut<int>* cut = finder->GetMinCut();
+
+    ASSERT_EQUALS(cut->Capacity(), stream);
+    ASSERT_EQUALS(cut->SourceSide()->Get(0), start);
+
+    // Vertices of the test graphs are numbers from 0
+    DynamicArray<bool> onSourceSide(g->VertexCount());
+
+    for (int v = 0; v < g->VertexCount(); v++)
+        onSourceSide.Set(false, v);
+
+    for (int i = 0; i < cut->SourceSide()->GetLength(); i++)
+        onSourceSide.Set(true, cut->SourceSide()->Get(i));
+
+    TestEnvironment::Assert(!onSourceSide.Get(end));
+
+    for (int i = 0; i < cut->CutEdges()->GetLength(); i++)
+    {
+        std::pair<int, int> edge = cut->CutEdges()->Get(i);
+
+        TestEnvironment::Assert(onSourceSide.Get(edge.first));
+        TestEnvironment::Assert(!onSourceSide.Get(edge.second));
+        ASSERT_EQUALS(streams->EdgeLength(edge.first, edge.second), g->EdgeLength(edge.first, edge.second));
+    }
+
+    delete(cut);
+}
+
+void testMinCut()
+{
+    Graph<int>* g = IntegerGraphFactory::Empty(4);
+
+    g->SetAdjacent(0, 1, 5);
+    g->SetAdjacent(1, 2, 2);
+    g->SetAdjacent(2, 3, 7);
+    g->SetAdjacent(2, 1, 4);
+
+    IStreamFinder<int>* f = new EdmondsKarpStreamFinder<int>(g, 0, 3);
+
+    MinCut<int>* cut = f->GetMinCut();
+
+    ASSERT_EQUALS(cut->Capacity(), 2);
+    AssertSequenceEquals({ 0, 1 }, cut->SourceSide());
+    ASSERT_EQUALS(cut->CutEdges()->GetLength(), 1);
+    ASSERT_EQUALS(cut->CutEdges()->Get(0).first, 1);
+    ASSERT_EQUALS(cut->CutEdges()->Get(0).second, 2);
+
+    // End cannot be reached at all
+    g->RemoveAdjacent(1, 2);
+
+    IStreamFinder<int>* f1 = new DinicStreamFinder<int>(g, 0, 3);
+
+    MinCut<int>* cut1 = f1->GetMinCut();
+
+    ASSERT_EQUALS(cut1->Capacity(), 0);
+    AssertSequenceEquals({ 0, 1 }, cut1->SourceSide());
+    ASSERT_EQUALS(cut1->CutEdges()->GetLength(), 0);
+
+    Graph<int>* g1 = createStreamGraph();
+
+    assertValidMinCut(g1, new EdmondsKarpStreamFinder<int>(g1, 0, 8), 0, 8);
+    assertValidMinCut(g1, new DinicStreamFinder<int>(g1, 0, 8), 0, 8);
+    assertValidMinCut(g1, new PushRelabelStreamFinder<int>(g1, 0, 8), 0, 8);
+    assertValidMinCut(g1, new ParallelPushRelabelStreamFinder<int>(g1, 0, 8, 4), 0, 8);
+
+    const int size = 30;
+
+    Graph<int>* complete = IntegerGraphFactory::Complete(size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            if (i != j)
+                complete->SetAdjacent(i, j, (i * 31 + j * 17) % 97 + 1);
+
+    assertValidMinCut(complete, new PushRelabelStreamFinder<int>(complete, 3, 17), 3, 17);
+    assertValidMinCut(complete, new DinicStreamFinder<int>(complete, 3, 17), 3, 17);
+
+    delete(cut);
+    delete(cut1);
+    delete(f);
+    delete(f1);
+}
+
+void testBidirectionalDijkstra()
+{
+    Graph<int>* g = createPathfindingGraph();
+    Graph<int>* reversed = g->Transposed();
+
+    ASSERT_EQUALS(reversed->EdgeLength(8, 0), 3);
+    TestEnvironment::Assert(!reversed->AreConnected(0, 8));
+
+    BidirectionalDijkstraPathfinder<int>* p = new BidirectionalDijkstraPathfinder<int>(g, 0);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p->GetPath(10));
+    ASSERT_EQUALS(p->GetDistance(10), 14);
+
+    for (int start = 0; start < 11; start++)
+    {
+        DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(g, start);
+        BidirectionalDijkstraPathfinder<int>* actual = new BidirectionalDijkstraPathfinder<int>(g, reversed, start);
+
+        for (int end = 0; end < 11; end++)
+        {
+            int distance = expected->GetDistance(end);
+
+            ASSERT_EQUALS(actual->GetDistance(end), distance);
+
+            if (distance < DijkstraPathfinder<int>::inf)
+                assertPathLength(g, actual->GetPath(end), start, end, distance);
+            else
+                ASSERT_THROWS(actual->GetPath(end), vertex_not_found);
+        }
+
+        delete(expected);
+        delete(actual);
+    }
+
+    Graph<int>* c200 = IntegerGraphFactory::Cycle(200);
+
+    BidirectionalDijkstraPathfinder<int>* p1 = new BidirectionalDijkstraPathfinder<int>(c200, 0);
+
+    ASSERT_EQUALS(p1->GetDistance(30), 30);
+    TestEnvironment::Assert(p1->CheckedCount() < 100);
+}
+
+void testAStar()
+{
+    const int width = 30;
+
+    Graph<int>* g = IntegerGraphFactory::Grid(width, width);
+
+    // Slow column in the middle of the grid
+    for (int y = 0; y < width - 1; y++)
+        g->SetBidirectionalEdge(y * width + 15, (y + 1) * width + 15, 5);
+
+    AStarPathfinder<int>::Heuristic manhattan = [](int vertex, int target)->int {
+        return abs(vertex % width - target % width) + abs(vertex / width - target / width);
+    };
+
+    DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(g, 0);
+    AStarPathfinder<int>* actual = new AStarPathfinder<int>(g, 0, manhattan);
+
+    ASSERT_EQUALS(actual->GetDistance(width * width - 1), 2 * (width - 1));
+    assertPathLength(g, actual->GetPath(width * width - 1), 0, width * width - 1, 2 * (width - 1));
+
+    ASSERT_EQUALS(actual->GetDistance(width - 1), width - 1);
+    TestEnvironment::Assert(actual->CheckedCount() < 2 * width);
+
+    int targets[] = { 1, 15, 45, 17 * width + 16, 20 * width + 3, width * width - 2 };
+
+    for (int target : targets)
+    {
+        ASSERT_EQUALS(actual->GetDistance(target), expected->GetDistance(target));
+        assertPathLength(g, actual->GetPath(target), 0, target, expected->GetDistance(target));
+    }
+
+    TestEnvironment::Assert(actual->CheckedCount() < expected->CheckedCount());
+
+    ASSERT_EQUALS(actual->GetWithin(3)->GetLength(), 10);
+    ASSERT_EQUALS(actual->GetDistance(width * width - 1), 2 * (width - 1));
+}
+
+void testLandmarks()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    LandmarkTable<int>* small = new LandmarkTable<int>(g, 3);
+
+    ASSERT_EQUALS(small->LandmarkCount(), 3);
+
+    DistanceTable<int>* distances = new DistanceTable<int>(g);
+
+    for (int v = 0; v < 11; v++)
+        for (int t = 0; t < 11; t++)
+            TestEnvironment::Assert(small->LowerBound(v, t) <= distances->GetDistance(v, t));
+
+    LandmarkPathfinder<int>* p = new LandmarkPathfinder<int>(g, 0, small);
+
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p->GetPath(10));
+
+    const int width = 30;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    // Slow column in the middle of the grid
+    for (int y = 0; y < width - 1; y++)
+        grid->SetBidirectionalEdge(y * width + 15, (y + 1) * width + 15, 5);
+
+    LandmarkTable<int>* landmarks = new LandmarkTable<int>(grid, 4);
+
+    ASSERT_EQUALS(landmarks->LandmarkCount(), 4);
+
+    // First landmarks go to the corners of the grid
+    ASSERT_EQUALS(landmarks->LandmarkAt(0), width * width - 1);
+    ASSERT_EQUALS(landmarks->LandmarkAt(1), 0);
+
+    int targets[] = { 1, 15, 45, 17 * width + 16, 20 * width + 3, width * width - 2 };
+
+    for (int target : targets)
+    {
+        DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(grid, 0);
+        LandmarkPathfinder<int>* actual = new LandmarkPathfinder<int>(grid, 0, landmarks);
+
+        ASSERT_EQUALS(actual->GetDistance(target), expected->GetDistance(target));
+        assertPathLength(grid, actual->GetPath(target), 0, target, expected->GetDistance(target));
+
+        TestEnvironment::Assert(actual->CheckedCount() <= expected->CheckedCount());
+
+        delete(expected);
+        delete(actual);
+    }
+
+    // Directed graph, where some vertices cannot reach the landmarks or be reached from them.
+    // One pathfinder answers for many targets, so distances found for earlier ones must be final
+    Graph<int>* directed = new Graph<int>([](int a, int b)->int {return a % b;});
+
+    for (int v = 0; v < 9; v++)
+        directed->AddVertex(v);
+
+    directed->SetAdjacent(0, 7, 5);
+    directed->SetAdjacent(0, 6, 19);
+    directed->SetAdjacent(4, 3, 15);
+    directed->SetAdjacent(4, 5, 1);
+    directed->SetAdjacent(4, 8, 10);
+    directed->SetAdjacent(5, 0, 5);
+    directed->SetAdjacent(5, 3, 1);
+    directed->SetAdjacent(6, 2, 19);
+    directed->SetAdjacent(6, 5, 8);
+    directed->SetAdjacent(8, 1, 13);
+
+    LandmarkTable<int>* directedLandmarks = new LandmarkTable<int>(directed, 3);
+    DistanceTable<int>* directedDistances = new DistanceTable<int>(directed);
+
+    for (int v = 0; v < 9; v++)
+        for (int t = 0; t < 9; t++)
+            TestEnvironment::Assert(directedLandmarks->LowerBound(v, t) <= directedDistances->GetDistance(v, t));
+
+    ASSERT_EQUALS(directedLandmarks->LowerBound(3, 0), LandmarkTable<int>::inf);
+
+    for (int start = 0; start < 9; start++)
+    {
+        LandmarkPathfinder<int>* shared = new LandmarkPathfinder<int>(directed, start, directedLandmarks);
+
+        for (int target : { 2, 3, 1, 7, 0, 5, 8, 6, 4 })
+            ASSERT_EQUALS(shared->GetDistance(target), directedDistances->GetDistance(start, target));
+
+        delete(shared);
+    }
+
+    delete(p);
+    delete(small);
+    delete(landmarks);
+    delete(distances);
+    delete(directedLandmarks);
+    delete(directedDistances);
+}
+
+void testDistanceTable()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    DistanceTable<int>* table = new DistanceTable<int>(g, 4);
+
+    ASSERT_EQUALS(table->SourceCount(), 11);
+    ASSERT_EQUALS(table->TargetCount(), 11);
+
+    for (int start = 0; start < 11; start++)
+    {
+        DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(g, start);
+
+        for (int end = 0; end < 11; end++)
+            ASSERT_EQUALS(table->GetDistance(start, end), expected->GetDistance(end));
+
+        delete(expected);
+    }
+
+    ArraySequence<int>* sources = new ArraySequence<int>({ 9, 2 });
+
+    DistanceTable<int>* partial = new DistanceTable<int>(g, sources, 2);
+
+    ASSERT_EQUALS(partial->SourceCount(), 2);
+    ASSERT_EQUALS(partial->GetDistance(2, 10), 8);
+    ASSERT_EQUALS(partial->GetDistance(9, 0), DistanceTable<int>::inf);
+    ASSERT_THROWS(partial->GetDistance(0, 10), vertex_not_found);
+
+    ArraySequence<int>* missing = new ArraySequence<int>({ 2, 42 });
+
+    ASSERT_THROWS(new DistanceTable<int>(g, missing, 4), vertex_not_found);
+
+    delete(table);
+    delete(partial);
+}
+
+void testParallelFor()
+{
+    ThreadPool* pool = new ThreadPool();
+
+    const int count = 1000;
+
+    DynamicArray<int> visits(count);
+
+    for (int i = 0; i < count; i++)
+        visits.Set(0, i);
+
+    pool->For(count, 4, [&](int i, int thread) {
+        TestEnvironment::Assert(thread >= 0 && thread < 4);
+        visits.Set(visits.Get(i) + 1, i);
+    });
+
+    for (int i = 0; i < count; i++)
+        ASSERT_EQUALS(visits.Get(i), 1);
+
+    // Workers are started once and kept for the next loops
+    ASSERT_EQUALS(pool->WorkerCount(), 3);
+
+    for (int i = 0; i < 100; i++)
+        pool->For(8, 4, [&](int i, int thread) {});
+
+    ASSERT_EQUALS(pool->WorkerCount(), 3);
+
+    // Exception from a worker thread is thrown by the loop, and the pool still works
+    ASSERT_THROWS(pool->For(count, 4, [&](int i, int thread) {
+        if (i == 500)
+            throw std::out_of_range("Index is too large");
+    }), std::out_of_range);
+
+    std::atomic<int> sum(0);
+
+    // Loop inside a loop runs on the thread of the outer one
+    pool->For(10, 4, [&](int i, int thread) {
+        pool->For(10, 4, [&](int j, int innerThread) {
+            sum += j;
+        });
+    });
+
+    ASSERT_EQUALS(sum.load(), 450);
+
+    delete(pool);
+}
+
+void testFloydWarshall()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    FloydWarshallTable<int>* table = new FloydWarshallTable<int>(g, 2);
+
+    ASSERT_EQUALS(table->VertexCount(), 11);
+    ASSERT_EQUALS(table->GetDistance(0, 10), 14);
+    ASSERT_EQUALS(table->NextHop(0, 10), 8);
+    AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, table->GetPath(0, 10));
+    AssertSequenceEquals({ 4 }, table->GetPath(4, 4));
+    ASSERT_EQUALS(table->GetDistance(9, 0), FloydWarshallTable<int>::inf);
+    ASSERT_THROWS(table->GetPath(9, 0), vertex_not_found);
+
+    // More vertices than fit in one tile, with different weights of edges each way
+    const int size = 150;
+
+    Graph<int>* complete = IntegerGraphFactory::Complete(size);
+
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            if (i != j)
+                complete->SetAdjacent(i, j, (i * 31 + j * 17) % 97 + 1);
+
+    FloydWarshallTable<int>* dense = new FloydWarshallTable<int>(complete);
+    DistanceTable<int>* expected = new DistanceTable<int>(complete);
+
+    for (int start = 0; start < size; start++)
+        for (int end = 0; end < size; end++)
+            ASSERT_EQUALS(dense->GetDistance(start, end), expected->GetDistance(start, end));
+
+    int starts[] = { 0, 70, 149 };
+
+    for (int start : starts)
+        for (int end = 0; end < size; end += 7)
+            assertPathLength(complete, dense->GetPath(start, end), start, end, expected->GetDistance(start, end));
+
+    delete(table);
+    delete(dense);
+    delete(expected);
+}
+
+void testDeltaStepping()
+{
+    Graph<int>* g = createPathfindingGraph();
+
+    CompactGraph<int>* compact = new CompactGraph<int>(g);
+
+    ASSERT_EQUALS(compact->VertexCount(), 11);
+    ASSERT_EQUALS(compact->EdgeCount(), 27);
+    ASSERT_EQUALS(compact->MaxWeight(), 16);
+
+    int deltas[] = { 0, 1, 3, 100 };
+
+    for (int delta : deltas)
+    {
+        DeltaSteppingPathfinder<int>* p = new DeltaSteppingPathfinder<int>(compact, 0, delta, 2);
+
+        AssertSequenceEquals({ 0, 8, 2, 6, 7, 10 }, p->GetPath(10));
+        ASSERT_EQUALS(p->GetDistance(10), 14);
+        ASSERT_EQUALS(p->GetDistance(4), 12);
+
+        DeltaSteppingPathfinder<int>* p1 = new DeltaSteppingPathfinder<int>(compact, 9, delta, 2);
+
+        ASSERT_EQUALS(p1->GetDistance(1), DeltaSteppingPathfinder<int>::inf);
+        ASSERT_THROWS(p1->GetPath(1), vertex_not_found);
+
+        delete(p);
+        delete(p1);
+    }
+
+    // Grid with varying weights, big enough for buckets to be relaxed by several threads
+    const int width = 100;
+
+    Graph<int>* grid = IntegerGraphFactory::Grid(width, width);
+
+    for (int v = 0; v + 1 < width * width; v++)
+        if ((v + 1) % width != 0)
+            grid->SetAdjacent(v, v + 1, (v * 7) % 13 + 1);
+
+    // Workers are started with the pathfinder, not during the search
+    ThreadPool* pool = new ThreadPool();
+
+    DijkstraPathfinder<int>* expected = new DijkstraPathfinder<int>(grid, 0);
+    DeltaSteppingPathfinder<int>* actual = new DeltaSteppingPathfinder<int>(grid, 0, 20, 4, pool);
+
+    ASSERT_EQUALS(pool->WorkerCount(), 3);
+
+    for (int v = 0; v < width * width; v++)
+        ASSERT_EQUALS(actual->GetDistance(v), expected->GetDistance(v));
+
+    assertPathLength(grid, actual->GetPath(width * width - 1), 0, width * width - 1,
+        expected->GetDistance(width * width - 1));
+
+    delete(compact);
+    delete(expected);
+    delete(actual);
+    delete(pool);
 }
\ No newline at end of file
@@ -8,7 +8,18 @@
 #include "Graph.h"
 #include "GraphFactory.h"
 #include "GraphPathfinder.h"
+#include "DistanceTable.h"
+#include "FloydWarshallTable.h"
+#include "LandmarkTable.h"
+#include "DeltaSteppingPathfinder.h"
+#include "ContractionHierarchy.h"
+#include "ShortestPathCache.h"
+#include "DynamicPathfinder.h"
 #include "MaxStreamFinder.h"
+#include "ParallelStreamFinder.h"
+#include "GomoryHuTree.h"
+#include "ResidualNetwork.h"
+#include "IntHash.h"
 
 void testAdjacencyList();
 
@@ -16,6 +27,30 @@ void basicGraphTest();
 
 void topologyGenerationTest();
 
+void testPriorityQueues();
+
 void testDijkstra();
 
-void testEdmondsKarp();
\ No newline at end of file
+void testBidirectionalDijkstra();
+
+void testAStar();
+void testLandmarks();
+
+void testDistanceTable();
+void testParallelFor();
+void testFloydWarshall();
+
+void testDeltaStepping();
+void testContractionHierarchy();
+void testShortestPathCache();
+void testDynamicPathfinder();
+
+void testEdmondsKarp();
+void testCapacityScaling();
+void testDinic();
+void testPushRelabel();
+void testParallelPushRelabel();
+void testMinCut();
+void testEdgeStreams();
+void testWarmStartedStream();
+void testGomoryHuTree();
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+//Queue of items ordered by integer priority, smallest priority comes out first
+template<class T>
+class IPriorityQueue
+{
+public:
+	virtual void Push(T item, int priority) = 0;
+	//New priority must not be greater than the current one
+	virtual void DecreasePriority(T item, int priority) = 0;
+	virtual T PopMin() = 0;
+
+	virtual int MinPriority() const = 0;
+	virtual bool Contains(T item) const = 0;
+
+	virtual int Count() const = 0;
+	virtual bool IsEmpty() const = 0;
+
+	virtual void Clear() = 0;
+
+	virtual ~IPriorityQueue()
+	{};
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "EdgeStreams.h"
+#include "Graph.h"
+#include "MinCut.h"
+
+//Finds the maximum stream from one vertex to another, edge weights are taken as capacities
+template<class T>
+class IStreamFinder
+{
+public:
+	//Value of the maximum stream
+	virtual int FindStream() = 0;
+	//Stream through every edge, negative if it goes the other way.
+	//Graph is not deleted together with the finder
+	virtual Graph<T>* GetStreams() = 0;
+	//Stream through every edge of the graph in flat arrays, deleted by the caller.
+	//Takes much less memory than GetStreams()
+	virtual EdgeStreams<T>* GetEdgeStreams() = 0;
+	//Vertices on the side of the start and the edges across the minimum cut,
+	//deleted by the caller
+	virtual MinCut<T>* GetMinCut() = 0;
+
+	virtual ~IStreamFinder()
+	{};
+};
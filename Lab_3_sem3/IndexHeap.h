@@ -0,0 +1,162 @@
+#pragma once
+
+#include <utility>
+#include <stdexcept>
+
+#include "dependencies/DynamicArray.h"
+
+#include "IPriorityQueue.h"
+
+using namespace sequences;
+
+//Binary min-heap of numbers from 0 to size - 1, such as vertex numbers of VertexIndex.
+//Positions are kept in an array instead of a hash map, so no step allocates anything
+class IndexHeap : public IPriorityQueue<int>
+{
+public:
+	typedef std::pair<int, int> HeapItem;
+private:
+	DynamicArray<HeapItem>* items;
+	//Position of every number in the heap, -1 if it is not queued
+	DynamicArray<int>* positions;
+
+	int itemsCount;
+public:
+	IndexHeap(int size) :
+		items(new DynamicArray<HeapItem>(size + 1)), positions(new DynamicArray<int>(size + 1)), itemsCount(0)
+	{
+		for (int i = 0; i < size; i++)
+			positions->Set(-1, i);
+	}
+public:
+	void Push(int item, int priority) override
+	{
+		if (Contains(item))
+			throw std::invalid_argument("Item is already in the queue!");
+
+		Place(std::make_pair(priority, item), itemsCount);
+		itemsCount++;
+
+		SiftUp(itemsCount - 1);
+	}
+	void DecreasePriority(int item, int priority) override
+	{
+		int index = positions->Get(item);
+
+		if (index < 0)
+			throw std::invalid_argument("Item is not in the queue!");
+
+		if (priority > items->Get(index).first)
+			throw std::invalid_argument("Priority can only be decreased!");
+
+		Place(std::make_pair(priority, item), index);
+
+		SiftUp(index);
+	}
+	int PopMin() override
+	{
+		if (itemsCount == 0)
+			throw std::out_of_range("Queue is empty!");
+
+		int res = items->Get(0).second;
+
+		positions->Set(-1, res);
+		itemsCount--;
+
+		if (itemsCount > 0)
+		{
+			Place(items->Get(itemsCount), 0);
+			SiftDown(0);
+		}
+
+		return res;
+	}
+public:
+	int MinPriority() const override
+	{
+		if (itemsCount == 0)
+			throw std::out_of_range("Queue is empty!");
+
+		return items->Get(0).first;
+	}
+	bool Contains(int item) const override
+	{
+		return positions->Get(item) >= 0;
+	}
+	int PriorityOf(int item) const
+	{
+		int index = positions->Get(item);
+
+		if (index < 0)
+			throw std::invalid_argument("Item is not in the queue!");
+
+		return items->Get(index).first;
+	}
+	int Count() const override
+	{
+		return itemsCount;
+	}
+	bool IsEmpty() const override
+	{
+		return itemsCount == 0;
+	}
+	void Clear() override
+	{
+		for (int i = 0; i < itemsCount; i++)
+			positions->Set(-1, items->Get(i).second);
+
+		itemsCount = 0;
+	}
+private:
+	void Place(HeapItem item, int index)
+	{
+		items->Set(item, index);
+		positions->Set(index, item.second);
+	}
+	void SiftUp(int index)
+	{
+		HeapItem item = items->Get(index);
+
+		while (index > 0)
+		{
+			int parent = (index - 1) / 2;
+			HeapItem parentItem = items->Get(parent);
+
+			if (parentItem.first <= item.first)
+				break;
+
+			Place(parentItem, index);
+			index = parent;
+		}
+
+		Place(item, index);
+	}
+	void SiftDown(int index)
+	{
+		HeapItem item = items->Get(index);
+
+		while (2 * index + 1 < itemsCount)
+		{
+			int child = 2 * index + 1;
+
+			if (child + 1 < itemsCount && items->Get(child + 1).first < items->Get(child).first)
+				child++;
+
+			HeapItem childItem = items->Get(child);
+
+			if (item.first <= childItem.first)
+				break;
+
+			Place(childItem, index);
+			index = child;
+		}
+
+		Place(item, index);
+	}
+public:
+	~IndexHeap()
+	{
+		delete(items);
+		delete(positions);
+	}
+};
@@ -9,6 +9,7 @@
 #include "GraphFactory.h"
 #include "GraphPathfinder.h"
 #include "MaxStreamFinder.h"
+#include "ParallelStreamFinder.h"
 
 #include "GraphTests.h"
 
@@ -137,6 +138,25 @@ Graph<int>* createGraphWithTopology(int topology, int size)
     }
 }
 
+IStreamFinder<int>* createStreamFinder(int algorithm, Graph<int>* graph, int start, int end)
+{
+    switch (algorithm)
+    {
+    case 1:
+        return new EdmondsKarpStreamFinder<int>(graph, start, end);
+    case 2:
+        return new DinicStreamFinder<int>(graph, start, end);
+    case 3:
+        return new PushRelabelStreamFinder<int>(graph, start, end);
+    case 4:
+        return new ParallelPushRelabelStreamFinder<int>(graph, start, end);
+    case 5:
+        return new CapacityScalingStreamFinder<int>(graph, start, end);
+    default:
+        return nullptr;
+    }
+}
+
 void header()
 {
     cout << "Commands:\n"
@@ -147,7 +167,7 @@ void header()
         << "5. Remove vertex\n"
         << "6. Remove edge\n"
         << "7. Find shortest way (Dijkstra algorithm)\n"
-        << "8. Find maximum stream (Edmonds-Karp algorithm)\n"
+        << "8. Find maximum stream\n"
         << "9. Print graph\n"
         << "10. Run tests\n"
         << "0. Exit\n";
@@ -176,8 +196,27 @@ int main()
         ADD_NEW_TEST(*env, "AdjacencyList test", testAdjacencyList);
         ADD_NEW_TEST(*env, "Basic graph test", basicGraphTest);
         ADD_NEW_TEST(*env, "Topology generation test", topologyGenerationTest);
+        ADD_NEW_TEST(*env, "Priority queues test", testPriorityQueues);
         ADD_NEW_TEST(*env, "Dijkstra test", testDijkstra);
+        ADD_NEW_TEST(*env, "Bidirectional Dijkstra test", testBidirectionalDijkstra);
+        ADD_NEW_TEST(*env, "A* test", testAStar);
+        ADD_NEW_TEST(*env, "Landmarks test", testLandmarks);
+        ADD_NEW_TEST(*env, "Distance table test", testDistanceTable);
+        ADD_NEW_TEST(*env, "Thread pool test", testParallelFor);
+        ADD_NEW_TEST(*env, "Floyd-Warshall test", testFloydWarshall);
+        ADD_NEW_TEST(*env, "Delta-stepping test", testDeltaStepping);
+        ADD_NEW_TEST(*env, "Contraction hierarchy test", testContractionHierarchy);
+        ADD_NEW_TEST(*env, "Shortest path cache test", testShortestPathCache);
+        ADD_NEW_TEST(*env, "Dynamic pathfinder test", testDynamicPathfinder);
         ADD_NEW_TEST(*env, "Edmonds-Karp algorithm test", testEdmondsKarp);
+        ADD_NEW_TEST(*env, "Capacity scaling test", testCapacityScaling);
+        ADD_NEW_TEST(*env, "Dinic algorithm test", testDinic);
+        ADD_NEW_TEST(*env, "Push-relabel algorithm test", testPushRelabel);
+        ADD_NEW_TEST(*env, "Parallel push-relabel algorithm test", testParallelPushRelabel);
+        ADD_NEW_TEST(*env, "Minimum cut test", testMinCut);
+        ADD_NEW_TEST(*env, "Edge streams test", testEdgeStreams);
+        ADD_NEW_TEST(*env, "Warm-started stream test", testWarmStartedStream);
+        ADD_NEW_TEST(*env, "Gomory-Hu tree test", testGomoryHuTree);
 
         try {
             switch (command)
@@ -294,7 +333,14 @@ int main()
                     cout << "Input stream end\n";
                     end = inputNumberInRange(0, index - 1);
 
-                    EdmondsKarpStreamFinder<int>* streams = new EdmondsKarpStreamFinder<int>(graph, start, end);
+                    cout << "Select algorithm:\n";
+                    cout << "1 - Edmonds-Karp\n";
+                    cout << "2 - Dinic\n";
+                    cout << "3 - push-relabel\n";
+                    cout << "4 - parallel push-relabel\n";
+                    cout << "5 - Edmonds-Karp with capacity scaling\n";
+
+                    IStreamFinder<int>* streams = createStreamFinder(inputNumberInRange(1, 5), graph, start, end);
 
                     cout << "Max stream = " << streams->FindStream() << '\n'
                         << *streams->GetStreams() << '\n';
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "dependencies/DynamicArray.h"
+
+#include "Graph.h"
+#include "GraphPathfinder.h"
+#include "PathfinderWorkspace.h"
+#include "VertexIndex.h"
+
+// Distances from and to a few landmark vertices, that give lower bounds of the distance
+// between any two vertices by the triangle inequality:
+// d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L).
+// Landmark can also show that v cannot reach t at all: L reaches v but not t, or t reaches L
+// but v does not. Bound is inf then, and stays inf along every edge into v, so together with
+// the largest of the other bounds it is a consistent heuristic for AStarPathfinder (ALT),
+// that needs no coordinates of vertices. Landmarks are picked one by one, each as far
+// as possible from the ones picked before, so they lie on the edges of the graph
+template<class T>
+class LandmarkTable
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	VertexIndex<T>* index;
+
+	int landmarkCount;
+	DynamicArray<T>* landmarks;
+
+	// Row for every landmark, column for every vertex
+	DynamicArray<int>* fromLandmark;
+	DynamicArray<int>* toLandmark;
+public:
+	LandmarkTable(Graph<T>* graph, int count) :
+		index(new VertexIndex<T>(graph)), landmarkCount(0)
+	{
+		int vertexCount = index->Count();
+
+		if (count > vertexCount)
+			count = vertexCount;
+
+		landmarks = new DynamicArray<T>(count + 1);
+		fromLandmark = new DynamicArray<int>(count * vertexCount + 1);
+		toLandmark = new DynamicArray<int>(count * vertexCount + 1);
+
+		if (vertexCount == 0)
+			return;
+
+		Graph<T>* reversedGraph = graph->Transposed();
+		PathfinderWorkspace<T>* workspace = new PathfinderWorkspace<T>(graph->GetHashFunction());
+
+		// Smallest distance from the landmarks picked so far to every vertex
+		DynamicArray<int> closest(vertexCount);
+
+		for (int v = 0; v < vertexCount; v++)
+			closest.Set(inf, v);
+
+		// First landmark is the farthest vertex from an arbitrary one
+		T next = Farthest(graph, index->VertexAt(0), workspace);
+
+		while (landmarkCount < count)
+		{
+			int row = landmarkCount * vertexCount;
+
+			landmarks->Set(next, landmarkCount);
+			landmarkCount++;
+
+			DijkstraPathfinder<T> backward(reversedGraph, next, workspace);
+
+			backward.Dijkstra();
+
+			for (int v = 0; v < vertexCount; v++)
+				toLandmark->Set(backward.GetTentativeDistance(index->VertexAt(v)), row + v);
+
+			DijkstraPathfinder<T> forward(graph, next, workspace);
+
+			forward.Dijkstra();
+
+			int farthest = -1;
+
+			for (int v = 0; v < vertexCount; v++)
+			{
+				int distance = forward.GetTentativeDistance(index->VertexAt(v));
+
+				fromLandmark->Set(distance, row + v);
+
+				if (distance < closest.Get(v))
+					closest.Set(distance, v);
+
+				// Vertices unreachable from all landmarks are the best next ones
+				if (farthest == -1 || closest.Get(v) > closest.Get(farthest))
+					farthest = v;
+			}
+
+			next = index->VertexAt(farthest);
+		}
+
+		delete(workspace);
+		delete(reversedGraph);
+	}
+public:
+	// Lower bound of the distance from the vertex to the end vertex, inf if it cannot be reached
+	int LowerBound(T vertex, T endVertex) const
+	{
+		int v = index->IndexOf(vertex);
+		int t = index->IndexOf(endVertex);
+
+		int vertexCount = index->Count();
+		int res = 0;
+
+		for (int i = 0; i < landmarkCount; i++)
+		{
+			int row = i * vertexCount;
+
+			int fromV = fromLandmark->Get(row + v);
+			int fromT = fromLandmark->Get(row + t);
+
+			int toV = toLandmark->Get(row + v);
+			int toT = toLandmark->Get(row + t);
+
+			// Path from v to t would make a path from L to t, or from v to L
+			if ((fromV < inf && fromT >= inf) || (toV >= inf && toT < inf))
+				return inf;
+
+			if (fromV < inf && fromT < inf && fromT - fromV > res)
+				res = fromT - fromV;
+
+			if (toV < inf && toT < inf && toV - toT > res)
+				res = toV - toT;
+		}
+
+		return res;
+	}
+
+	// Heuristic for AStarPathfinder, valid while the table exists
+	typename AStarPathfinder<T>::Heuristic Heuristic() const
+	{
+		return [this](T vertex, T endVertex) { return LowerBound(vertex, endVertex); };
+	}
+
+	int LandmarkCount() const
+	{
+		return landmarkCount;
+	}
+	T LandmarkAt(int landmark) const
+	{
+		return landmarks->Get(landmark);
+	}
+private:
+	T Farthest(Graph<T>* graph, T vertex, PathfinderWorkspace<T>* workspace) const
+	{
+		DijkstraPathfinder<T> pathfinder(graph, vertex, workspace);
+
+		pathfinder.Dijkstra();
+
+		T res = vertex;
+		int resDistance = 0;
+
+		for (int v = 0; v < index->Count(); v++)
+		{
+			int distance = pathfinder.GetTentativeDistance(index->VertexAt(v));
+
+			if (distance < inf && distance > resDistance)
+			{
+				res = index->VertexAt(v);
+				resDistance = distance;
+			}
+		}
+
+		return res;
+	}
+public:
+	~LandmarkTable()
+	{
+		delete(index);
+		delete(landmarks);
+		delete(fromLandmark);
+		delete(toLandmark);
+	}
+};
+
+// A* with lower bounds from a landmark table. Table is not copied,
+// so many pathfinders over the same graph can share one
+template<class T>
+class LandmarkPathfinder : public AStarPathfinder<T>
+{
+public:
+	LandmarkPathfinder(Graph<T>* graph, T startVertex, LandmarkTable<T>* landmarks,
+		QueueType queueType = QueueType::BINARY_HEAP) :
+		AStarPathfinder<T>(graph, startVertex, landmarks->Heuristic(), queueType)
+	{}
+};
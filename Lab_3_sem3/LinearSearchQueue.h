@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "dependencies/HashMap.h"
+
+#include "IPriorityQueue.h"
+
+using namespace dictionary;
+
+//Unordered queue, every pop scans all queued items for the smallest priority
+template<class T>
+class LinearSearchQueue : public IPriorityQueue<T>
+{
+private:
+	HashMap<T, int>* items;
+public:
+	LinearSearchQueue(std::function<int(T, int)> hashFunc) :
+		items(new HashMap<T, int>(hashFunc))
+	{}
+public:
+	void Push(T item, int priority) override
+	{
+		if (items->Contains(item))
+			throw std::invalid_argument("Item is already in the queue!");
+
+		items->Add(item, priority);
+	}
+	void DecreasePriority(T item, int priority) override
+	{
+		if (priority > items->Get(item))
+			throw std::invalid_argument("Priority can only be decreased!");
+
+		items->Add(item, priority);
+	}
+	T PopMin() override
+	{
+		T res = FindMin().first;
+
+		items->Remove(res);
+
+		return res;
+	}
+public:
+	int MinPriority() const override
+	{
+		return FindMin().second;
+	}
+	bool Contains(T item) const override
+	{
+		return items->Contains(item);
+	}
+	int Count() const override
+	{
+		return items->Count();
+	}
+	bool IsEmpty() const override
+	{
+		return items->Count() == 0;
+	}
+	void Clear() override
+	{
+		items->Clear();
+	}
+private:
+	std::pair<T, int> FindMin() const
+	{
+		if (IsEmpty())
+			throw std::out_of_range("Queue is empty!");
+
+		auto iter = items->Iterator();
+
+		std::pair<T, int> min = *iter;
+
+		for (; iter != items->End(); ++iter)
+		{
+			if ((*iter).second < min.second)
+				min = *iter;
+		}
+
+		return min;
+	}
+public:
+	~LinearSearchQueue()
+	{
+		delete(items);
+	}
+};
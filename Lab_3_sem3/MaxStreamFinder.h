@@ -1,171 +1,994 @@
 #pragma once
 
+#include "dependencies/DynamicArray.h"
+
 #include "Graph.h"
+#include "IStreamFinder.h"
+#include "ResidualNetwork.h"
+
+
+// Breadth-first search over arcs of a residual network, that can take more flow.
+// Finds a path with the fewest arcs and stops as soon as the end vertex is reached.
+// Nothing is allocated or cleared between searches: every mark remembers the search it
+// was made by, as in PathfinderWorkspace
+template<class T>
+class AugmentingPathFinder
+{
+private:
+	ResidualNetwork<T>* network;
+
+	// Arc every vertex was reached by, -1 for the start
+	DynamicArray<int>* pathArcs;
+	// Number of the search that reached the vertex
+	DynamicArray<int>* reachedBy;
+	// Vertices in order they were reached, each one once
+	DynamicArray<int>* queue;
+
+	int stamp;
+public:
+	AugmentingPathFinder(ResidualNetwork<T>* network) :
+		network(network), pathArcs(new DynamicArray<int>(network->VertexCount() + 1)),
+		reachedBy(new DynamicArray<int>(network->VertexCount() + 1)),
+		queue(new DynamicArray<int>(network->VertexCount() + 1)), stamp(0)
+	{
+		for (int v = 0; v < network->VertexCount(); v++)
+			reachedBy->Set(0, v);
+	}
+
+	// Only arcs that can take at least minResidual more flow are used
+	bool Find(int startVertex, int endVertex, int minResidual = 1)
+	{
+		stamp++;
+
+		int queueBegin = 0;
+		int queueEnd = 0;
+
+		Reach(startVertex, -1, queueEnd);
+
+		while (queueBegin < queueEnd)
+		{
+			int tmp = queue->Get(queueBegin);
+			queueBegin++;
+
+			for (int arc = network->ArcsBegin(tmp); arc < network->ArcsEnd(tmp); arc++)
+			{
+				int end = network->ArcEnd(arc);
+
+				if (network->Residual(arc) < minResidual || IsReached(end))
+					continue;
+
+				Reach(end, arc, queueEnd);
+
+				if (end == endVertex)
+					return true;
+			}
+		}
 
+		return false;
+	}
+
+	bool IsReached(int vertex) const
+	{
+		return reachedBy->Get(vertex) == stamp;
+	}
+	// Arc the latest search reached the vertex by, -1 for its start
+	int PathArc(int vertex) const
+	{
+		return pathArcs->Get(vertex);
+	}
+
+	// Pushes as much flow along the path to the end vertex, as its narrowest arc can take.
+	// Returns the amount pushed
+	int Augment(int endVertex)
+	{
+		return Augment(endVertex, network->Residual(pathArcs->Get(endVertex)));
+	}
+	// Same, but pushes no more than the limit
+	int Augment(int endVertex, int limit)
+	{
+		int min = limit;
+
+		for (int arc = pathArcs->Get(endVertex); arc != -1; arc = pathArcs->Get(network->ArcStart(arc)))
+		{
+			if (network->Residual(arc) < min)
+				min = network->Residual(arc);
+		}
+
+		for (int arc = pathArcs->Get(endVertex); arc != -1; arc = pathArcs->Get(network->ArcStart(arc)))
+			network->Push(arc, min);
+
+		return min;
+	}
+private:
+	void Reach(int vertex, int arc, int& queueEnd)
+	{
+		reachedBy->Set(stamp, vertex);
+		pathArcs->Set(arc, vertex);
+
+		queue->Set(vertex, queueEnd);
+		queueEnd++;
+	}
+public:
+	~AugmentingPathFinder()
+	{
+		delete(pathArcs);
+		delete(reachedBy);
+		delete(queue);
+	}
+};
 
 template<class T>
-class EdmondsKarpStreamFinder
+class EdmondsKarpStreamFinder : public IStreamFinder<T>
 {
 private:
 	Graph<T>* maxStreams;
 
+	// Flow found so far, changed in place by every increasing path
+	ResidualNetwork<T>* network;
 	Graph<T>* currentStreams;
-	Graph<T>* remainingGrid;
 
-	T startVertex;
-	T endVertex;
+	int startVertex;
+	int endVertex;
+
+	AugmentingPathFinder<T>* pathFinder;
 
 	bool algorithmStarted = false;
 	bool streamsInUse = false;
 public:
 	EdmondsKarpStreamFinder<T>(Graph<T>* graph, T startVertex, T endVertex):
-		maxStreams(graph), startVertex(startVertex), endVertex(endVertex),
-		currentStreams(new Graph<T>(graph->GetHashFunction())), remainingGrid(new Graph<T>(graph->GetHashFunction()))
+		maxStreams(graph), network(new ResidualNetwork<T>(graph)), currentStreams(nullptr)
 	{
 		if (startVertex == endVertex)
 			throw std::invalid_argument("Start and end of a stream cannot be the same vertex!");
 
-		auto vertexIter = graph->begin();
+		this->startVertex = network->IndexOf(startVertex);
+		this->endVertex = network->IndexOf(endVertex);
 
-		for (; vertexIter != graph->end(); ++vertexIter)
+		pathFinder = new AugmentingPathFinder<T>(network);
+	}
+
+	// Flow found before is kept, so after capacities change only the difference is searched for
+	int FindStream() override
+	{
+		algorithmStarted = true;
+
+		while (pathFinder->Find(startVertex, endVertex))
+			pathFinder->Augment(endVertex);
+
+		return -network->Outflow(endVertex);
+	}
+
+	// Changes capacity of an edge of the graph, keeping the stream found so far.
+	// When the edge gets more than it can take now, the extra flow is sent around it,
+	// and what cannot be sent around goes back to the ends of the stream.
+	// Next FindStream() only adds flow, that the new capacities allow
+	void SetCapacity(T startVertex, T endVertex, int capacity)
+	{
+		if (capacity < 0)
+			throw std::invalid_argument("Capacity cannot be negative!");
+
+		int start = network->IndexOf(startVertex);
+		int end = network->IndexOf(endVertex);
+		int arc = network->EdgeArc(start, end);
+
+		if (arc == -1)
+			throw vertex_not_found("There is no such edge in the graph");
+
+		maxStreams->SetAdjacent(startVertex, endVertex, capacity);
+		network->SetCapacity(arc, capacity);
+
+		if (currentStreams != nullptr)
 		{
-			currentStreams->AddVertex((*vertexIter).first);
+			if (!streamsInUse)
+				delete(currentStreams);
+
+			currentStreams = nullptr;
+			streamsInUse = false;
 		}
 
-		vertexIter = graph->begin();
+		int overflow = network->Flow(arc) - capacity;
 
-		for (; vertexIter != graph->end(); ++vertexIter)
-		{
-			auto edgeStart = (*vertexIter).first;
-			auto edgeIter = graph->AdjacentIterator(edgeStart);
+		if (overflow <= 0)
+			return;
 
-			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
-			{
-				auto edgeEnd = (*edgeIter)->GetEnd();
+		// Start of the edge now gets more than it gives, and its end the other way round
+		network->Push(arc, -overflow);
+
+		int left = overflow;
+
+		while (left > 0 && pathFinder->Find(start, end))
+			left -= pathFinder->Augment(end, left);
 
-				currentStreams->SetAdjacent(edgeStart, edgeEnd, 0);
-				currentStreams->SetAdjacent(edgeEnd, edgeStart, 0);
+		if (start != this->startVertex && start != this->endVertex)
+			Balance(start, left, true);
+
+		if (end != this->startVertex && end != this->endVertex)
+			Balance(end, left, false);
+	}
+
+	Graph<T>* GetStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
 
+		if (currentStreams == nullptr)
+			currentStreams = network->CreateFlowGraph(maxStreams->GetHashFunction());
+
+		streamsInUse = true;
+
+		return currentStreams;
+	}
+
+	EdgeStreams<T>* GetEdgeStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateEdgeStreams();
+	}
+
+	MinCut<T>* GetMinCut() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateMinCut(startVertex);
+	}
+
+private:
+	// Sends extra flow of the vertex back to one of the ends of the stream,
+	// or brings the missing flow from them
+	void Balance(int vertex, int amount, bool extra)
+	{
+		int ends[] = { this->startVertex, this->endVertex };
+
+		for (int other : ends)
+		{
+			if (extra)
+			{
+				while (amount > 0 && pathFinder->Find(vertex, other))
+					amount -= pathFinder->Augment(other, amount);
 			}
+			else
+			{
+				while (amount > 0 && pathFinder->Find(other, vertex))
+					amount -= pathFinder->Augment(vertex, amount);
+			}
+		}
+	}
+
+public:
+	~EdmondsKarpStreamFinder()
+	{
+		if(!streamsInUse)
+			delete(currentStreams);
+
+		delete(network);
+		delete(pathFinder);
+	}
 
-		
+};
+
+// Edmonds-Karp algorithm with capacity scaling: increasing paths are searched only among
+// arcs that can take at least delta more flow, and delta is halved when there are none left.
+// It starts from the largest power of two not above the largest capacity, so the first
+// paths carry a lot of flow, and there are O(E) paths in every phase.
+// Works best when capacities differ by orders of magnitude
+template<class T>
+class CapacityScalingStreamFinder : public IStreamFinder<T>
+{
+private:
+	Graph<T>* maxStreams;
+
+	ResidualNetwork<T>* network;
+	Graph<T>* currentStreams;
+
+	int startVertex;
+	int endVertex;
+
+	AugmentingPathFinder<T>* pathFinder;
+
+	bool algorithmStarted = false;
+	bool streamsInUse = false;
+public:
+	CapacityScalingStreamFinder(Graph<T>* graph, T startVertex, T endVertex) :
+		maxStreams(graph), network(new ResidualNetwork<T>(graph)), currentStreams(nullptr)
+	{
+		if (startVertex == endVertex)
+			throw std::invalid_argument("Start and end of a stream cannot be the same vertex!");
+
+		this->startVertex = network->IndexOf(startVertex);
+		this->endVertex = network->IndexOf(endVertex);
+
+		pathFinder = new AugmentingPathFinder<T>(network);
+	}
+
+	int FindStream() override
+	{
+		if (algorithmStarted)
+			return -network->Outflow(endVertex);
+
+		algorithmStarted = true;
+
+		int maxCapacity = 0;
+
+		for (int arc = 0; arc < network->ArcCount(); arc++)
+			if (network->Capacity(arc) > maxCapacity)
+				maxCapacity = network->Capacity(arc);
+
+		int delta = 1;
+
+		while (delta <= maxCapacity / 2)
+			delta *= 2;
+
+		for (; delta >= 1; delta /= 2)
+		{
+			while (pathFinder->Find(startVertex, endVertex, delta))
+				pathFinder->Augment(endVertex);
 		}
 
-		CreateRemainingGrid();
+		return -network->Outflow(endVertex);
+	}
+
+	Graph<T>* GetStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		if (currentStreams == nullptr)
+			currentStreams = network->CreateFlowGraph(maxStreams->GetHashFunction());
 
-		//std::cout << *currentStreams << '\n' << *remainingGrid << '\n';
+		streamsInUse = true;
+
+		return currentStreams;
+	}
+
+	EdgeStreams<T>* GetEdgeStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateEdgeStreams();
+	}
+
+	MinCut<T>* GetMinCut() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateMinCut(startVertex);
 	}
 
-	int FindStream()
+public:
+	~CapacityScalingStreamFinder()
+	{
+		if (!streamsInUse)
+			delete(currentStreams);
+
+		delete(network);
+		delete(pathFinder);
+	}
+};
+
+// Dinic algorithm: breadth-first search splits vertices into levels by the number of arcs
+// from the start, then flow is pushed only along arcs going one level up, until no such
+// path is left (blocking flow). Every arc that led to a dead end is skipped until the
+// next level split, so every phase takes O(V * E), and there are at most V phases.
+// Much faster than Edmonds-Karp on networks with unit capacities
+template<class T>
+class DinicStreamFinder : public IStreamFinder<T>
+{
+private:
+	Graph<T>* maxStreams;
+
+	ResidualNetwork<T>* network;
+	Graph<T>* currentStreams;
+
+	int startVertex;
+	int endVertex;
+
+	// Number of arcs from the start, -1 if the vertex is not reached
+	DynamicArray<int>* levels;
+	// First arc of every vertex, that can still lead to the end in the current phase
+	DynamicArray<int>* currentArcs;
+	// Queue of the level search
+	DynamicArray<int>* vertexQueue;
+	// Arcs from the start to the vertex the blocking flow search is at
+	DynamicArray<int>* path;
+
+	bool algorithmStarted = false;
+	bool streamsInUse = false;
+public:
+	DinicStreamFinder(Graph<T>* graph, T startVertex, T endVertex) :
+		maxStreams(graph), network(new ResidualNetwork<T>(graph)), currentStreams(nullptr)
+	{
+		if (startVertex == endVertex)
+			throw std::invalid_argument("Start and end of a stream cannot be the same vertex!");
+
+		this->startVertex = network->IndexOf(startVertex);
+		this->endVertex = network->IndexOf(endVertex);
+
+		int vertexCount = network->VertexCount();
+
+		levels = new DynamicArray<int>(vertexCount + 1);
+		currentArcs = new DynamicArray<int>(vertexCount + 1);
+		vertexQueue = new DynamicArray<int>(vertexCount + 1);
+		path = new DynamicArray<int>(vertexCount + 1);
+	}
+
+	int FindStream() override
 	{
 		algorithmStarted = true;
 
+		while (SplitLevels())
+			BlockingFlow();
+
+		return -network->Outflow(endVertex);
+	}
+
+	Graph<T>* GetStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		if (currentStreams == nullptr)
+			currentStreams = network->CreateFlowGraph(maxStreams->GetHashFunction());
+
+		streamsInUse = true;
+
+		return currentStreams;
+	}
+
+	EdgeStreams<T>* GetEdgeStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateEdgeStreams();
+	}
+
+	MinCut<T>* GetMinCut() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateMinCut(startVertex);
+	}
+
+private:
+	// Returns false, if the end vertex cannot be reached anymore
+	bool SplitLevels()
+	{
+		for (int v = 0; v < network->VertexCount(); v++)
+		{
+			levels->Set(-1, v);
+			currentArcs->Set(network->ArcsBegin(v), v);
+		}
+
+		int queueBegin = 0;
+		int queueEnd = 0;
+
+		levels->Set(0, startVertex);
+		vertexQueue->Set(startVertex, queueEnd);
+		queueEnd++;
+
+		while (queueBegin < queueEnd)
+		{
+			int tmp = vertexQueue->Get(queueBegin);
+			queueBegin++;
+
+			// Vertices farther than the end cannot be on a path going up to it
+			if (levels->Get(tmp) >= levels->Get(endVertex) && levels->Get(endVertex) != -1)
+				break;
+
+			for (int arc = network->ArcsBegin(tmp); arc < network->ArcsEnd(tmp); arc++)
+			{
+				int end = network->ArcEnd(arc);
+
+				if (network->Residual(arc) <= 0 || levels->Get(end) != -1)
+					continue;
+
+				levels->Set(levels->Get(tmp) + 1, end);
+				vertexQueue->Set(end, queueEnd);
+				queueEnd++;
+			}
+		}
+
+		return levels->Get(endVertex) != -1;
+	}
+
+	// Depth-first search along current arcs, without recursion: path is kept as a stack of arcs
+	void BlockingFlow()
+	{
+		int pathLength = 0;
+		int tmp = startVertex;
+
 		while (true)
 		{
-			Sequence<T>* increasingPath = FindIncreasingPath();
+			if (tmp == endVertex)
+			{
+				int min = network->Residual(path->Get(0));
+
+				for (int i = 1; i < pathLength; i++)
+				{
+					if (network->Residual(path->Get(i)) < min)
+						min = network->Residual(path->Get(i));
+				}
+
+				for (int i = 0; i < pathLength; i++)
+					network->Push(path->Get(i), min);
+
+				// Search goes on from the start of the first arc that is full now
+				for (int i = 0; i < pathLength; i++)
+				{
+					if (network->Residual(path->Get(i)) == 0)
+					{
+						pathLength = i;
+						break;
+					}
+				}
+
+				tmp = pathLength == 0 ? startVertex : network->ArcEnd(path->Get(pathLength - 1));
+				continue;
+			}
+
+			int arc = NextArc(tmp);
+
+			if (arc != -1)
+			{
+				path->Set(arc, pathLength);
+				pathLength++;
+
+				tmp = network->ArcEnd(arc);
+				continue;
+			}
+
+			// Dead end, nothing else can get through this vertex in the current phase
+			if (tmp == startVertex)
+				return;
 
-			if (increasingPath == nullptr)
+			pathLength--;
+			tmp = network->ArcStart(path->Get(pathLength));
+
+			currentArcs->Set(currentArcs->Get(tmp) + 1, tmp);
+		}
+	}
+
+	// First arc from the vertex one level up, that can take more flow, -1 if there is none
+	int NextArc(int vertex)
+	{
+		int arc = currentArcs->Get(vertex);
+
+		for (; arc < network->ArcsEnd(vertex); arc++)
+		{
+			int end = network->ArcEnd(arc);
+
+			if (network->Residual(arc) > 0 && levels->Get(end) == levels->Get(vertex) + 1)
 				break;
+		}
+
+		currentArcs->Set(arc, vertex);
+
+		return arc < network->ArcsEnd(vertex) ? arc : -1;
+	}
+
+public:
+	~DinicStreamFinder()
+	{
+		if (!streamsInUse)
+			delete(currentStreams);
+
+		delete(network);
+		delete(levels);
+		delete(currentArcs);
+		delete(vertexQueue);
+		delete(path);
+	}
+};
+
+// Push-relabel algorithm: the start sends as much as its arcs can take, then vertices
+// with more coming in than going out (active ones) push the excess to lower neighbours,
+// and are lifted when they have none. Active vertex with the highest label goes first.
+// Two heuristics keep labels close to the real distances to the end:
+// when no vertex is left at some label below VertexCount(), the vertices above it
+// cannot reach the end and are lifted at once (gap), and from time to time all labels
+// are set to the distances found by breadth-first search backwards from the end,
+// and from the start for the vertices that send their excess back (global relabeling)
+template<class T>
+class PushRelabelStreamFinder : public IStreamFinder<T>
+{
+private:
+	Graph<T>* maxStreams;
+
+	ResidualNetwork<T>* network;
+	Graph<T>* currentStreams;
 
-			TracePath(increasingPath);
+	int startVertex;
+	int endVertex;
 
-			CreateRemainingGrid();
+	int vertexCount;
 
-			//std::cout << *dynamic_cast<ArraySequence<T>*>(increasingPath) << '\n';
-			//std::cout << *currentStreams << '\n';// << *remainingGrid << '\n';
+	DynamicArray<int>* labels;
+	DynamicArray<int>* excess;
+	// First arc of every vertex, that can still take its excess at the current label
+	DynamicArray<int>* currentArcs;
+
+	// All vertices with every label below VertexCount(), as doubly linked lists,
+	// so the gap heuristic lifts only the vertices above the gap
+	DynamicArray<int>* labelFirst;
+	DynamicArray<int>* labelNext;
+	DynamicArray<int>* labelPrev;
+	// No vertex has a label above it and below VertexCount()
+	int maxLabel;
+	// Active vertices with every label, as linked lists
+	DynamicArray<int>* activeFirst;
+	DynamicArray<int>* activeNext;
+	DynamicArray<bool>* queued;
+	// No active vertex has a higher label
+	int maxActiveLabel;
+
+	// Queue of the backward search
+	DynamicArray<int>* vertexQueue;
+
+	// Arcs looked at by relabeling since the last global relabeling
+	int relabelWork;
+
+	bool algorithmStarted = false;
+	bool streamsInUse = false;
+public:
+	PushRelabelStreamFinder(Graph<T>* graph, T startVertex, T endVertex) :
+		maxStreams(graph), network(new ResidualNetwork<T>(graph)), currentStreams(nullptr)
+	{
+		if (startVertex == endVertex)
+			throw std::invalid_argument("Start and end of a stream cannot be the same vertex!");
+
+		this->startVertex = network->IndexOf(startVertex);
+		this->endVertex = network->IndexOf(endVertex);
+
+		vertexCount = network->VertexCount();
+
+		labels = new DynamicArray<int>(vertexCount + 1);
+		excess = new DynamicArray<int>(vertexCount + 1);
+		currentArcs = new DynamicArray<int>(vertexCount + 1);
+		labelFirst = new DynamicArray<int>(vertexCount + 1);
+		labelNext = new DynamicArray<int>(vertexCount + 1);
+		labelPrev = new DynamicArray<int>(vertexCount + 1);
+		activeFirst = new DynamicArray<int>(2 * vertexCount + 1);
+		activeNext = new DynamicArray<int>(vertexCount + 1);
+		queued = new DynamicArray<bool>(vertexCount + 1);
+		vertexQueue = new DynamicArray<int>(vertexCount + 1);
+	}
+
+	int FindStream() override
+	{
+		if (algorithmStarted)
+			return -network->Outflow(endVertex);
+
+		algorithmStarted = true;
+
+		for (int v = 0; v < vertexCount; v++)
+			excess->Set(0, v);
+
+		for (int arc = network->ArcsBegin(startVertex); arc < network->ArcsEnd(startVertex); arc++)
+		{
+			int amount = network->Residual(arc);
+
+			if (amount > 0)
+			{
+				network->Push(arc, amount);
+				excess->Set(excess->Get(network->ArcEnd(arc)) + amount, network->ArcEnd(arc));
+			}
 		}
 
-		auto iter = currentStreams->AdjacentIterator(endVertex);
+		GlobalRelabel();
 
-		int sum = 0;
+		while (true)
+		{
+			while (maxActiveLabel >= 0 && activeFirst->Get(maxActiveLabel) == -1)
+				maxActiveLabel--;
+
+			if (maxActiveLabel < 0)
+				break;
+
+			int tmp = activeFirst->Get(maxActiveLabel);
+
+			activeFirst->Set(activeNext->Get(tmp), maxActiveLabel);
+			queued->Set(false, tmp);
+
+			Discharge(tmp);
 
-		for (; iter != currentStreams->AdjacentEnd(); ++iter)
-			sum += (*iter)->GetWeight();
+			if (relabelWork > global_relabel_work * vertexCount + network->ArcCount())
+				GlobalRelabel();
+		}
 
-		return -sum;
+		return -network->Outflow(endVertex);
 	}
 
-	Graph<T>* GetStreams()
+	Graph<T>* GetStreams() override
 	{
 		if (!algorithmStarted)
 			FindStream();
 
+		if (currentStreams == nullptr)
+			currentStreams = network->CreateFlowGraph(maxStreams->GetHashFunction());
+
 		streamsInUse = true;
 
 		return currentStreams;
 	}
 
+	EdgeStreams<T>* GetEdgeStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateEdgeStreams();
+	}
+
+	MinCut<T>* GetMinCut() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateMinCut(startVertex);
+	}
+
 private:
-	void CreateRemainingGrid()
+	// Global relabeling runs, when relabeling has looked at this many arcs per vertex
+	// plus all arcs once
+	static const int global_relabel_work = 6;
+
+	// Pushes all excess of the vertex away, lifting it when it has no arc to push along
+	void Discharge(int vertex)
 	{
-		delete(remainingGrid);
+		while (excess->Get(vertex) > 0)
+		{
+			int arc = currentArcs->Get(vertex);
 
-		remainingGrid = new Graph<T>(maxStreams->GetHashFunction());
+			if (arc == network->ArcsEnd(vertex))
+			{
+				Relabel(vertex);
 
-		auto vertexIter = maxStreams->begin();
+				// Label is out of range only if the excess has nowhere to go
+				if (labels->Get(vertex) >= 2 * vertexCount)
+					return;
 
-		for (; vertexIter != maxStreams->end(); ++vertexIter)
+				continue;
+			}
+
+			int end = network->ArcEnd(arc);
+
+			if (network->Residual(arc) > 0 && labels->Get(vertex) == labels->Get(end) + 1)
+			{
+				int amount = network->Residual(arc) < excess->Get(vertex) ? network->Residual(arc) : excess->Get(vertex);
+
+				network->Push(arc, amount);
+
+				excess->Set(excess->Get(vertex) - amount, vertex);
+				excess->Set(excess->Get(end) + amount, end);
+
+				// End became active
+				if (excess->Get(end) == amount)
+					Activate(end);
+			}
+			else
+				currentArcs->Set(arc + 1, vertex);
+		}
+	}
+
+	void Relabel(int vertex)
+	{
+		int oldLabel = labels->Get(vertex);
+		int newLabel = 2 * vertexCount;
+
+		for (int arc = network->ArcsBegin(vertex); arc < network->ArcsEnd(vertex); arc++)
 		{
-			remainingGrid->AddVertex((*vertexIter).first);
+			if (network->Residual(arc) > 0 && labels->Get(network->ArcEnd(arc)) + 1 < newLabel)
+				newLabel = labels->Get(network->ArcEnd(arc)) + 1;
 		}
 
-		vertexIter = maxStreams->begin();
+		relabelWork += network->ArcsEnd(vertex) - network->ArcsBegin(vertex) + 1;
 
-		for (; vertexIter != maxStreams->end(); ++vertexIter)
+		SetLabel(vertex, newLabel);
+		currentArcs->Set(network->ArcsBegin(vertex), vertex);
+
+		if (oldLabel < vertexCount && labelFirst->Get(oldLabel) == -1)
+			Gap(oldLabel);
+	}
+
+	// Nothing above the empty label can reach the end, so those vertices
+	// can only send their excess back to the start. Active ones are moved
+	// to the active list of the new label
+	void Gap(int emptyLabel)
+	{
+		for (int label = emptyLabel + 1; label <= maxLabel; label++)
 		{
-			auto edgeStart = (*vertexIter).first;
-			auto edgeIter = maxStreams->AdjacentIterator(edgeStart);
+			for (int v = labelFirst->Get(label); v != -1; v = labelNext->Get(v))
+			{
+				labels->Set(vertexCount, v);
+				currentArcs->Set(network->ArcsBegin(v), v);
+			}
 
-			for (; edgeIter != maxStreams->AdjacentEnd(); ++edgeIter)
+			labelFirst->Set(-1, label);
+
+			int next;
+
+			for (int v = activeFirst->Get(label); v != -1; v = next)
 			{
-				auto edgeEnd = (*edgeIter)->GetEnd();
+				next = activeNext->Get(v);
 
-				if ((*edgeIter)->GetWeight() != currentStreams->EdgeLength(edgeStart, edgeEnd))
-					remainingGrid->SetAdjacent(edgeStart, edgeEnd, 1);
+				activeNext->Set(activeFirst->Get(vertexCount), v);
+				activeFirst->Set(v, vertexCount);
 			}
+
+			activeFirst->Set(-1, label);
 		}
+
+		if (activeFirst->Get(vertexCount) != -1 && maxActiveLabel < vertexCount)
+			maxActiveLabel = vertexCount;
+
+		maxLabel = emptyLabel - 1;
 	}
 
-	Sequence<T>* FindIncreasingPath()
+	// Labels become distances to the end by arcs with free capacity, or the label of
+	// the start plus distances to it for vertices that cannot reach the end
+	void GlobalRelabel()
 	{
-		DijkstraPathfinder<T>* pathfinder = new DijkstraPathfinder<T>(remainingGrid, startVertex);
+		for (int v = 0; v < vertexCount; v++)
+		{
+			labels->Set(2 * vertexCount, v);
+			currentArcs->Set(network->ArcsBegin(v), v);
+		}
+
+		SearchBackwards(endVertex, 0);
+		SearchBackwards(startVertex, vertexCount);
+
+		for (int label = 0; label < vertexCount; label++)
+			labelFirst->Set(-1, label);
+
+		maxLabel = 0;
+
+		for (int v = 0; v < vertexCount; v++)
+			Link(v);
 
-		if (pathfinder->GetDistance(endVertex) >= DijkstraPathfinder<T>::inf)
-			return nullptr;
+		relabelWork = 0;
 
-		return pathfinder->GetPath(endVertex);
+		RebuildActive();
 	}
 
-	void TracePath(Sequence<T>* path)
+	// Gives labels to the vertices, that have not got one yet and can send flow to the root
+	void SearchBackwards(int root, int rootLabel)
 	{
-		int min = DijkstraPathfinder<T>::inf;
+		int queueBegin = 0;
+		int queueEnd = 0;
 
-		for (int i = 0; i < path->GetLength() - 1; i++)
+		labels->Set(rootLabel, root);
+		vertexQueue->Set(root, queueEnd);
+		queueEnd++;
+
+		while (queueBegin < queueEnd)
 		{
-			int remainderStream = maxStreams->EdgeLength(path->Get(i), path->Get(i + 1)) -
-				currentStreams->EdgeLength(path->Get(i), path->Get(i + 1));
+			int tmp = vertexQueue->Get(queueBegin);
+			queueBegin++;
+
+			for (int arc = network->ArcsBegin(tmp); arc < network->ArcsEnd(tmp); arc++)
+			{
+				int end = network->ArcEnd(arc);
 
-			if (remainderStream < min)
-				min = remainderStream;
+				// Pair of the arc goes from its end to this vertex
+				if (network->Residual(network->Pair(arc)) <= 0 || labels->Get(end) != 2 * vertexCount)
+					continue;
+
+				if (end == startVertex || end == endVertex)
+					continue;
+
+				labels->Set(labels->Get(tmp) + 1, end);
+				vertexQueue->Set(end, queueEnd);
+				queueEnd++;
+			}
 		}
+	}
 
-		for (int i = 0; i < path->GetLength() - 1; i++)
-		{
-			currentStreams->SetAdjacent(path->Get(i), path->Get(i + 1),
-				currentStreams->EdgeLength(path->Get(i), path->Get(i + 1)) + min);
+	void SetLabel(int vertex, int label)
+	{
+		Unlink(vertex);
+		labels->Set(label, vertex);
+		Link(vertex);
+	}
+
+	// Adds the vertex to the list of its label, if the label is below VertexCount()
+	void Link(int vertex)
+	{
+		int label = labels->Get(vertex);
 
-			currentStreams->SetAdjacent(path->Get(i + 1), path->Get(i),
-				currentStreams->EdgeLength(path->Get(i + 1), path->Get(i)) - min);
+		if (label >= vertexCount)
+			return;
+
+		int first = labelFirst->Get(label);
+
+		labelNext->Set(first, vertex);
+		labelPrev->Set(-1, vertex);
+
+		if (first != -1)
+			labelPrev->Set(vertex, first);
+
+		labelFirst->Set(vertex, label);
+
+		if (label > maxLabel)
+			maxLabel = label;
+	}
+	void Unlink(int vertex)
+	{
+		int label = labels->Get(vertex);
+
+		if (label >= vertexCount)
+			return;
+
+		int prev = labelPrev->Get(vertex);
+		int next = labelNext->Get(vertex);
+
+		if (prev == -1)
+			labelFirst->Set(next, label);
+		else
+			labelNext->Set(next, prev);
+
+		if (next != -1)
+			labelPrev->Set(prev, next);
+	}
+
+	void Activate(int vertex)
+	{
+		if (vertex == startVertex || vertex == endVertex || labels->Get(vertex) >= 2 * vertexCount)
+			return;
+
+		if (queued->Get(vertex))
+			return;
+
+		queued->Set(true, vertex);
+
+		int label = labels->Get(vertex);
+
+		activeNext->Set(activeFirst->Get(label), vertex);
+		activeFirst->Set(vertex, label);
+
+		if (label > maxActiveLabel)
+			maxActiveLabel = label;
+	}
+
+	// Labels of queued vertices have changed, so they are queued again
+	void RebuildActive()
+	{
+		for (int label = 0; label <= 2 * vertexCount; label++)
+			activeFirst->Set(-1, label);
+
+		maxActiveLabel = -1;
+
+		for (int v = 0; v < vertexCount; v++)
+			queued->Set(false, v);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			if (excess->Get(v) > 0)
+				Activate(v);
 		}
 	}
 
 public:
-	~EdmondsKarpStreamFinder()
+	~PushRelabelStreamFinder()
 	{
-		if(!streamsInUse)
+		if (!streamsInUse)
 			delete(currentStreams);
 
-		delete(remainingGrid);
+		delete(network);
+		delete(labels);
+		delete(excess);
+		delete(currentArcs);
+		delete(labelFirst);
+		delete(labelNext);
+		delete(labelPrev);
+		delete(activeFirst);
+		delete(activeNext);
+		delete(queued);
+		delete(vertexQueue);
 	}
-
-};
\ No newline at end of file
+};
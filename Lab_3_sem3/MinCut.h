@@ -0,0 +1,55 @@
+#pragma once
+
+#include <utility>
+
+#include "dependencies/ArraySequence.h"
+
+// Minimum cut between the start and the end of a maximum stream: vertices that can still
+// be reached from the start by arcs with free capacity (source side), and the edges going
+// from them to the rest of the vertices. All such edges are full, and their capacities
+// add up to the value of the stream
+template<class T>
+class MinCut
+{
+private:
+	Sequence<T>* sourceSide;
+	Sequence<std::pair<T, T>>* cutEdges;
+
+	int capacity;
+public:
+	MinCut() :
+		sourceSide(new ArraySequence<T>()), cutEdges(new ArraySequence<std::pair<T, T>>()), capacity(0)
+	{}
+public:
+	// Vertices on the side of the start, the start goes first
+	Sequence<T>* SourceSide() const
+	{
+		return sourceSide;
+	}
+	// Edges from the side of the start to the side of the end, as (start, end) pairs
+	Sequence<std::pair<T, T>>* CutEdges() const
+	{
+		return cutEdges;
+	}
+	// Sum of capacities of the cut edges
+	int Capacity() const
+	{
+		return capacity;
+	}
+
+	void AddVertex(T vertex)
+	{
+		sourceSide->Append(vertex);
+	}
+	void AddEdge(T startVertex, T endVertex, int edgeCapacity)
+	{
+		cutEdges->Append(std::make_pair(startVertex, endVertex));
+		capacity += edgeCapacity;
+	}
+public:
+	~MinCut()
+	{
+		delete(sourceSide);
+		delete(cutEdges);
+	}
+};
@@ -0,0 +1,174 @@
+#include "ParallelFor.h"
+
+// Set on threads running the body of a loop
+static thread_local bool insideLoop = false;
+
+int DefaultThreadCount()
+{
+	int threads = std::thread::hardware_concurrency();
+
+	return threads > 0 ? threads : 1;
+}
+
+ThreadPool::ThreadPool() :
+	body(nullptr), count(0), threadCount(0), next(0), working(0), generation(0), stopping(false)
+{}
+
+void ThreadPool::Reserve(int threadCount)
+{
+	std::lock_guard<std::mutex> loopLock(loopMutex);
+
+	while ((int)workers.size() < threadCount - 1)
+	{
+		int thread = (int)workers.size() + 1;
+		long long seen = generation.load();
+
+		workers.push_back(std::thread([this, thread, seen]() { Work(thread, seen); }));
+	}
+}
+
+void ThreadPool::For(int count, int threadCount, const std::function<void(int, int)>& body)
+{
+	if (threadCount > count)
+		threadCount = count;
+
+	if (threadCount <= 1 || insideLoop)
+	{
+		for (int i = 0; i < count; i++)
+			body(i, 0);
+
+		return;
+	}
+
+	Reserve(threadCount);
+
+	std::lock_guard<std::mutex> loopLock(loopMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		this->body = &body;
+		this->count = count;
+		this->threadCount = threadCount;
+
+		next.store(0);
+		working.store(threadCount - 1);
+		generation++;
+	}
+
+	wake.notify_all();
+
+	RunItems(0);
+
+	for (int spin = 0; spin < spin_count && working.load() > 0; spin++)
+		std::this_thread::yield();
+
+	if (working.load() > 0)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		done.wait(lock, [this]() { return working.load() == 0; });
+	}
+
+	std::exception_ptr loopError;
+
+	{
+		std::lock_guard<std::mutex> lock(errorMutex);
+
+		loopError = error;
+		error = nullptr;
+	}
+
+	if (loopError)
+		std::rethrow_exception(loopError);
+}
+
+int ThreadPool::WorkerCount() const
+{
+	return (int)workers.size();
+}
+
+ThreadPool* ThreadPool::Shared()
+{
+	static ThreadPool pool;
+
+	return &pool;
+}
+
+void ThreadPool::Work(int thread, long long seen)
+{
+	while (true)
+	{
+		for (int spin = 0; spin < spin_count && generation.load() == seen; spin++)
+			std::this_thread::yield();
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			wake.wait(lock, [&]() { return stopping || generation.load() != seen; });
+
+			if (stopping)
+				return;
+
+			seen = generation.load();
+
+			// Loop does not need this thread
+			if (thread >= threadCount)
+				continue;
+		}
+
+		RunItems(thread);
+
+		if (working.fetch_sub(1) == 1)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			done.notify_all();
+		}
+	}
+}
+
+void ThreadPool::RunItems(int thread)
+{
+	insideLoop = true;
+
+	// Indices are taken one by one, so threads that got cheap items take more of them
+	for (int i = next++; i < count; i = next++)
+	{
+		try
+		{
+			(*body)(i, thread);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(errorMutex);
+
+			if (!error)
+				error = std::current_exception();
+
+			// Other threads take no more indices
+			next.store(count);
+		}
+	}
+
+	insideLoop = false;
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		stopping = true;
+	}
+
+	wake.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+void ParallelFor(int count, int threadCount, std::function<void(int, int)> body)
+{
+	ThreadPool::Shared()->For(count, threadCount, body);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+int DefaultThreadCount();
+
+// Worker threads that live as long as the pool and run loops one at a time, so a loop
+// costs a wake-up instead of starting threads. Thread calling For works as thread 0.
+// Exception thrown by the body stops the loop, and is thrown again by For
+class ThreadPool
+{
+private:
+	std::vector<std::thread> workers;
+
+	// Guards the current loop, and lets workers sleep between loops
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	// Only one loop runs at a time
+	std::mutex loopMutex;
+
+	// Current loop, changed only while no worker runs it
+	const std::function<void(int, int)>* body;
+	int count;
+	int threadCount;
+	std::atomic<int> next;
+	// Workers that have not finished the current loop yet
+	std::atomic<int> working;
+	std::atomic<long long> generation;
+
+	std::mutex errorMutex;
+	std::exception_ptr error;
+
+	bool stopping;
+
+	// Workers and the calling thread check this many times for a loop or its end
+	// before they sleep, so short loops that go one after another are not slowed down
+	static const int spin_count = 2000;
+public:
+	ThreadPool();
+public:
+	// Starts workers, so that loops can run on the given number of threads
+	void Reserve(int threadCount);
+
+	// Calls body(index, thread) for every index from 0 to count - 1 on up to threadCount threads.
+	// Thread number is below threadCount, so it can be used to pick per-thread scratch data.
+	// Loop started from the body of another one runs on the calling thread
+	void For(int count, int threadCount, const std::function<void(int, int)>& body);
+
+	int WorkerCount() const;
+
+	// Pool shared by all parallel algorithms
+	static ThreadPool* Shared();
+private:
+	// Runs every loop after the one numbered seen, that needs the thread
+	void Work(int thread, long long seen);
+	void RunItems(int thread);
+public:
+	~ThreadPool();
+};
+
+// Calls body(index, thread) for every index from 0 to count - 1 on up to threadCount threads
+// of the shared pool. Thread number is below threadCount, so it can be used to pick per-thread
+// scratch data
+void ParallelFor(int count, int threadCount, std::function<void(int, int)> body);
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <atomic>
+
+#include "dependencies/ArraySequence.h"
+#include "dependencies/DynamicArray.h"
+
+#include "Graph.h"
+#include "IStreamFinder.h"
+#include "ParallelFor.h"
+#include "ResidualNetwork.h"
+
+// Push-relabel algorithm, where active vertices are discharged by several threads at once.
+// Work goes in rounds: all vertices active at the start of a round are discharged in
+// parallel, and vertices that got excess during the round make the list of the next one.
+// Thread discharging a vertex holds its lock, and locks the neighbour too for every push,
+// so flow of an arc and its pair only changes while both ends are locked. Neighbour that is
+// already locked is not waited for: discharge stops and the vertex goes to the next round.
+// If no thread could do anything in a round, the next one runs on one thread, so the search
+// always goes on. Labels are reset by breadth-first search backwards from the end and from
+// the start (global relabeling), which also runs on several threads, a level at a time.
+// There are many rounds and levels, so they run on the long-lived workers of a thread pool,
+// started when the finder is made. Gap heuristic is left out: global relabeling does its
+// work between the rounds
+template<class T>
+class ParallelPushRelabelStreamFinder : public IStreamFinder<T>
+{
+private:
+	Graph<T>* maxStreams;
+
+	ResidualNetwork<T>* network;
+	Graph<T>* currentStreams;
+
+	int startVertex;
+	int endVertex;
+
+	int vertexCount;
+	int threadCount;
+
+	ThreadPool* pool;
+
+	// Labels and excess are read by neighbours without locking
+	std::atomic<int>* labels;
+	std::atomic<int>* excess;
+	// Held by the thread discharging the vertex or pushing into it
+	std::atomic<bool>* locks;
+	// Vertex is already in the list of the next round
+	std::atomic<bool>* queued;
+	// First arc of every vertex, that can still take its excess at the current label.
+	// Changed only by the thread holding the lock of the vertex
+	DynamicArray<int>* currentArcs;
+
+	// Vertices discharged in the current round
+	ArraySequence<int>* active;
+	// Vertices each thread put into the next round, or found by the backward search
+	DynamicArray<ArraySequence<int>*>* found;
+
+	// Arcs looked at by relabeling since the last global relabeling
+	std::atomic<int> relabelWork;
+	// Some vertex pushed or was relabeled during the round
+	std::atomic<bool> progressed;
+
+	bool algorithmStarted = false;
+	bool streamsInUse = false;
+
+	// Rounds with fewer active vertices run on one thread
+	static const int min_parallel_active = 64;
+	// Global relabeling runs, when relabeling has looked at this many arcs per vertex
+	// plus all arcs once
+	static const int global_relabel_work = 6;
+public:
+	ParallelPushRelabelStreamFinder(Graph<T>* graph, T startVertex, T endVertex, int threadCount = DefaultThreadCount(),
+		ThreadPool* pool = ThreadPool::Shared()) :
+		maxStreams(graph), network(new ResidualNetwork<T>(graph)), currentStreams(nullptr),
+		threadCount(threadCount > 0 ? threadCount : 1), pool(pool), relabelWork(0), progressed(false)
+	{
+		if (startVertex == endVertex)
+			throw std::invalid_argument("Start and end of a stream cannot be the same vertex!");
+
+		this->startVertex = network->IndexOf(startVertex);
+		this->endVertex = network->IndexOf(endVertex);
+
+		vertexCount = network->VertexCount();
+
+		labels = new std::atomic<int>[vertexCount];
+		excess = new std::atomic<int>[vertexCount];
+		locks = new std::atomic<bool>[vertexCount];
+		queued = new std::atomic<bool>[vertexCount];
+		currentArcs = new DynamicArray<int>(vertexCount + 1);
+
+		active = new ArraySequence<int>();
+		found = new DynamicArray<ArraySequence<int>*>(this->threadCount);
+
+		for (int i = 0; i < this->threadCount; i++)
+			found->Set(new ArraySequence<int>(), i);
+
+		pool->Reserve(this->threadCount);
+	}
+
+	int FindStream() override
+	{
+		if (algorithmStarted)
+			return -network->Outflow(endVertex);
+
+		algorithmStarted = true;
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			excess[v].store(0);
+			locks[v].store(false);
+			queued[v].store(false);
+		}
+
+		for (int arc = network->ArcsBegin(startVertex); arc < network->ArcsEnd(startVertex); arc++)
+		{
+			int amount = network->Residual(arc);
+
+			if (amount > 0)
+			{
+				network->Push(arc, amount);
+				excess[network->ArcEnd(arc)] += amount;
+			}
+		}
+
+		GlobalRelabel();
+
+		bool sequential = false;
+
+		while (active->GetLength() > 0)
+		{
+			progressed.store(false);
+
+			int threads = sequential || active->GetLength() < min_parallel_active ? 1 : threadCount;
+
+			pool->For(active->GetLength(), threads, [&](int i, int thread) {
+				Discharge(active->Get(i), found->Get(thread));
+			});
+
+			active->Clear();
+
+			for (int thread = 0; thread < threadCount; thread++)
+			{
+				ArraySequence<int>* vertices = found->Get(thread);
+
+				for (int i = 0; i < vertices->GetLength(); i++)
+				{
+					queued[vertices->Get(i)].store(false);
+					active->Append(vertices->Get(i));
+				}
+
+				vertices->Clear();
+			}
+
+			sequential = !progressed.load();
+
+			if (relabelWork.load() > global_relabel_work * vertexCount + network->ArcCount())
+				GlobalRelabel();
+		}
+
+		return -network->Outflow(endVertex);
+	}
+
+	Graph<T>* GetStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		if (currentStreams == nullptr)
+			currentStreams = network->CreateFlowGraph(maxStreams->GetHashFunction());
+
+		streamsInUse = true;
+
+		return currentStreams;
+	}
+
+	EdgeStreams<T>* GetEdgeStreams() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateEdgeStreams();
+	}
+
+	MinCut<T>* GetMinCut() override
+	{
+		if (!algorithmStarted)
+			FindStream();
+
+		return network->CreateMinCut(startVertex);
+	}
+
+private:
+	// Pushes excess of the vertex away until it runs out, or a neighbour it has to push to is busy
+	void Discharge(int vertex, ArraySequence<int>* nextRound)
+	{
+		// Neighbour can hold the lock for a moment, while pushing into the vertex
+		if (locks[vertex].exchange(true))
+		{
+			Enqueue(vertex, nextRound);
+			return;
+		}
+
+		while (excess[vertex].load() > 0)
+		{
+			int arc = currentArcs->Get(vertex);
+
+			if (arc == network->ArcsEnd(vertex))
+			{
+				Relabel(vertex);
+
+				if (labels[vertex].load() >= 2 * vertexCount)
+					break;
+
+				continue;
+			}
+
+			int end = network->ArcEnd(arc);
+
+			if (network->Residual(arc) <= 0 || labels[vertex].load() != labels[end].load() + 1)
+			{
+				currentArcs->Set(arc + 1, vertex);
+				continue;
+			}
+
+			if (locks[end].exchange(true))
+				break;
+
+			// Label of the end could change before it was locked
+			if (labels[vertex].load() != labels[end].load() + 1)
+			{
+				locks[end].store(false);
+				currentArcs->Set(arc + 1, vertex);
+				continue;
+			}
+
+			int amount = network->Residual(arc) < excess[vertex].load() ? network->Residual(arc) : excess[vertex].load();
+
+			network->Push(arc, amount);
+
+			excess[vertex] -= amount;
+			int before = excess[end].fetch_add(amount);
+
+			locks[end].store(false);
+
+			progressed.store(true);
+
+			if (before == 0)
+				Enqueue(end, nextRound);
+		}
+
+		locks[vertex].store(false);
+
+		if (excess[vertex].load() > 0)
+			Enqueue(vertex, nextRound);
+	}
+
+	// Called with the lock of the vertex held, labels of neighbours can only grow meanwhile
+	void Relabel(int vertex)
+	{
+		int newLabel = 2 * vertexCount;
+
+		for (int arc = network->ArcsBegin(vertex); arc < network->ArcsEnd(vertex); arc++)
+		{
+			int label = labels[network->ArcEnd(arc)].load();
+
+			if (network->Residual(arc) > 0 && label + 1 < newLabel)
+				newLabel = label + 1;
+		}
+
+		relabelWork += network->ArcsEnd(vertex) - network->ArcsBegin(vertex) + 1;
+
+		labels[vertex].store(newLabel);
+		currentArcs->Set(network->ArcsBegin(vertex), vertex);
+
+		progressed.store(true);
+	}
+
+	void Enqueue(int vertex, ArraySequence<int>* nextRound)
+	{
+		if (vertex == startVertex || vertex == endVertex || labels[vertex].load() >= 2 * vertexCount)
+			return;
+
+		if (!queued[vertex].exchange(true))
+			nextRound->Append(vertex);
+	}
+
+	// Labels become distances to the end by arcs with free capacity, or the label of
+	// the start plus distances to it for vertices that cannot reach the end.
+	// Runs between rounds, when no vertex is locked
+	void GlobalRelabel()
+	{
+		for (int v = 0; v < vertexCount; v++)
+		{
+			labels[v].store(2 * vertexCount);
+			currentArcs->Set(network->ArcsBegin(v), v);
+		}
+
+		SearchBackwards(endVertex, 0);
+		SearchBackwards(startVertex, vertexCount);
+
+		relabelWork.store(0);
+
+		active->Clear();
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			queued[v].store(false);
+
+			if (excess[v].load() > 0 && v != startVertex && v != endVertex && labels[v].load() < 2 * vertexCount)
+				active->Append(v);
+		}
+	}
+
+	// Gives labels to the vertices, that have not got one yet and can send flow to the root.
+	// Every level is looked through by several threads, and the first thread to reach
+	// a vertex gives it the label
+	void SearchBackwards(int root, int rootLabel)
+	{
+		ArraySequence<int> frontier;
+
+		labels[root].store(rootLabel);
+		frontier.Append(root);
+
+		while (frontier.GetLength() > 0)
+		{
+			int threads = frontier.GetLength() < min_parallel_active ? 1 : threadCount;
+
+			pool->For(frontier.GetLength(), threads, [&](int i, int thread) {
+				int tmp = frontier.Get(i);
+				int label = labels[tmp].load() + 1;
+
+				for (int arc = network->ArcsBegin(tmp); arc < network->ArcsEnd(tmp); arc++)
+				{
+					int end = network->ArcEnd(arc);
+
+					// Pair of the arc goes from its end to this vertex
+					if (network->Residual(network->Pair(arc)) <= 0 || end == startVertex || end == endVertex)
+						continue;
+
+					int unlabeled = 2 * vertexCount;
+
+					if (labels[end].compare_exchange_strong(unlabeled, label))
+						found->Get(thread)->Append(end);
+				}
+			});
+
+			frontier.Clear();
+
+			for (int thread = 0; thread < threadCount; thread++)
+			{
+				ArraySequence<int>* vertices = found->Get(thread);
+
+				for (int i = 0; i < vertices->GetLength(); i++)
+					frontier.Append(vertices->Get(i));
+
+				vertices->Clear();
+			}
+		}
+	}
+
+public:
+	~ParallelPushRelabelStreamFinder()
+	{
+		if (!streamsInUse)
+			delete(currentStreams);
+
+		delete(network);
+		delete[](labels);
+		delete[](excess);
+		delete[](locks);
+		delete[](queued);
+		delete(currentArcs);
+		delete(active);
+
+		for (int i = 0; i < threadCount; i++)
+			delete(found->Get(i));
+
+		delete(found);
+	}
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <limits>
+#include <stdexcept>
+
+#include "dependencies/HashMap.h"
+
+#include "AdjacencyList.h"
+#include "Graph.h"
+#include "IPriorityQueue.h"
+#include "BinaryHeap.h"
+#include "BucketQueue.h"
+#include "LinearSearchQueue.h"
+
+using namespace dictionary;
+
+enum class QueueType
+{
+	// Scan all reached vertices for the closest one, O(V) per step
+	LINEAR_SEARCH,
+	// Binary heap with decrease-key, O(log V) per step
+	BINARY_HEAP,
+	// Bucket for every distance (Dial's algorithm), O(1) per step plus skipped empty buckets.
+	// For small integer edge weights
+	BUCKETS,
+	// Buckets if the maximum edge weight of the graph is small, binary heap otherwise
+	AUTO
+};
+
+// Search state of a pathfinder: distances, checked marks, previous vertices and the queue.
+// Kept between searches, so a new search does not allocate anything and does not
+// touch vertices the previous searches reached: every label remembers the search
+// it was written by, and labels of older searches are treated as empty.
+// Only one search can use a workspace at a time
+template<class T>
+class PathfinderWorkspace
+{
+public:
+	static const int inf = std::numeric_limits<int>::max() / 2;
+private:
+	struct VertexLabel
+	{
+		// Number of the search that wrote this label
+		int stamp;
+
+		int distance;
+		bool checked;
+
+		bool hasPrev;
+		T prev;
+	};
+
+	IDictionary<T, VertexLabel>* labels;
+
+	// Reached, but not checked vertices, ordered by distance
+	IPriorityQueue<T>* queue;
+
+	int stamp = 0;
+
+	// Graphs with heavier edges make too many empty buckets for QueueType::AUTO to pick them
+	static const int max_bucket_weight = 1024;
+public:
+	// QueueType::AUTO is treated as a binary heap, since there is no graph to look at
+	PathfinderWorkspace(std::function<int(T, int)> hashFunc, QueueType queueType = QueueType::BINARY_HEAP) :
+		labels(new HashMap<T, VertexLabel>(hashFunc)), queue(CreateQueue(queueType, hashFunc, 0))
+	{}
+
+	// Looks through all edges of the graph once, to size buckets and to resolve QueueType::AUTO
+	PathfinderWorkspace(Graph<T>* graph, QueueType queueType = QueueType::AUTO) :
+		labels(new HashMap<T, VertexLabel>(graph->GetHashFunction()))
+	{
+		int maxWeight = 0;
+
+		if (queueType == QueueType::BUCKETS || queueType == QueueType::AUTO)
+			maxWeight = graph->MaxEdgeWeight();
+
+		if (queueType == QueueType::AUTO)
+			queueType = maxWeight <= max_bucket_weight ? QueueType::BUCKETS : QueueType::BINARY_HEAP;
+
+		queue = CreateQueue(queueType, graph->GetHashFunction(), maxWeight);
+	}
+public:
+	// Forgets the previous search in O(1) plus what was left in the queue
+	void Reset()
+	{
+		stamp++;
+
+		queue->Clear();
+	}
+
+	int GetDistance(T vertex) const
+	{
+		return GetLabel(vertex).distance;
+	}
+	bool IsChecked(T vertex) const
+	{
+		return GetLabel(vertex).checked;
+	}
+	bool HasPrev(T vertex) const
+	{
+		return GetLabel(vertex).hasPrev;
+	}
+	T GetPrev(T vertex) const
+	{
+		VertexLabel label = GetLabel(vertex);
+
+		if (!label.hasPrev)
+			throw vertex_not_found("Vertex was not reached from the start");
+
+		return label.prev;
+	}
+
+	void SetStart(T vertex)
+	{
+		VertexLabel label = EmptyLabel();
+
+		label.distance = 0;
+
+		labels->Add(vertex, label);
+	}
+	void SetDistance(T vertex, int distance, T prev)
+	{
+		VertexLabel label = GetLabel(vertex);
+
+		label.distance = distance;
+		label.hasPrev = true;
+		label.prev = prev;
+
+		labels->Add(vertex, label);
+	}
+	void Check(T vertex)
+	{
+		VertexLabel label = GetLabel(vertex);
+
+		label.checked = true;
+
+		labels->Add(vertex, label);
+	}
+
+	IPriorityQueue<T>* Queue()
+	{
+		return queue;
+	}
+private:
+	VertexLabel GetLabel(T vertex) const
+	{
+		if (!labels->Contains(vertex))
+			return EmptyLabel();
+
+		VertexLabel label = labels->Get(vertex);
+
+		if (label.stamp != stamp)
+			return EmptyLabel();
+
+		return label;
+	}
+	VertexLabel EmptyLabel() const
+	{
+		VertexLabel label;
+
+		label.stamp = stamp;
+		label.distance = inf;
+		label.checked = false;
+		label.hasPrev = false;
+		label.prev = T();
+
+		return label;
+	}
+
+	static IPriorityQueue<T>* CreateQueue(QueueType queueType, std::function<int(T, int)> hashFunc, int maxWeight)
+	{
+		switch (queueType)
+		{
+		case QueueType::LINEAR_SEARCH:
+			return new LinearSearchQueue<T>(hashFunc);
+		case QueueType::BINARY_HEAP:
+		case QueueType::AUTO:
+			return new BinaryHeap<T>(hashFunc);
+		case QueueType::BUCKETS:
+			// Dijkstra keeps queued distances within the maximum edge weight of each other
+			return maxWeight > 0 ? new BucketQueue<T>(hashFunc, maxWeight + 1) : new BucketQueue<T>(hashFunc);
+		default:
+			throw std::invalid_argument("Unknown queue type");
+		}
+	}
+public:
+	~PathfinderWorkspace()
+	{
+		delete(labels);
+		delete(queue);
+	}
+};
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "dependencies/DynamicArray.h"
+
+#include "EdgeStreams.h"
+#include "Graph.h"
+#include "MinCut.h"
+#include "VertexIndex.h"
+
+// Graph with edge weights taken as capacities, and the flow through every edge.
+// Every edge u -> v is stored as a pair of arcs: u -> v with the capacity of the edge
+// and v -> u with capacity 0, so pushing flow along one arc gives it back to the other.
+// Flow of the paired arcs is always opposite, and residual capacity of an arc is its
+// capacity minus its flow. Arcs of vertex v, both edges and their pairs, have numbers
+// from ArcsBegin(v) to ArcsEnd(v) - 1, as in CompactGraph
+template<class T>
+class ResidualNetwork
+{
+private:
+	VertexIndex<T>* index;
+
+	// firstArc[v] is the number of the first arc of v, firstArc[VertexCount()] == ArcCount()
+	DynamicArray<int>* firstArc;
+	DynamicArray<int>* arcEnds;
+	DynamicArray<int>* capacities;
+	DynamicArray<int>* flows;
+	// Number of the arc going the other way
+	DynamicArray<int>* pairs;
+	// Arc is an edge of the graph, not the pair added for one
+	DynamicArray<bool>* edgeArcs;
+	// Arc of every edge, in the order the graph lists them
+	DynamicArray<int>* edgeOrder;
+
+	int arcCount;
+public:
+	ResidualNetwork(Graph<T>* graph) :
+		index(new VertexIndex<T>(graph)), arcCount(0)
+	{
+		int vertexCount = index->Count();
+
+		// Every edge gives an arc to both of its ends
+		DynamicArray<int> nextArc(vertexCount + 1);
+
+		for (int v = 0; v < vertexCount; v++)
+			nextArc.Set(0, v);
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(v));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				int end = index->IndexOf((*edgeIter)->GetEnd());
+
+				nextArc.Set(nextArc.Get(v) + 1, v);
+				nextArc.Set(nextArc.Get(end) + 1, end);
+
+				arcCount += 2;
+			}
+		}
+
+		firstArc = new DynamicArray<int>(vertexCount + 1);
+		arcEnds = new DynamicArray<int>(arcCount + 1);
+		capacities = new DynamicArray<int>(arcCount + 1);
+		flows = new DynamicArray<int>(arcCount + 1);
+		pairs = new DynamicArray<int>(arcCount + 1);
+		edgeArcs = new DynamicArray<bool>(arcCount + 1);
+		edgeOrder = new DynamicArray<int>(arcCount / 2 + 1);
+
+		int arc = 0;
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			firstArc->Set(arc, v);
+
+			arc += nextArc.Get(v);
+			nextArc.Set(firstArc->Get(v), v);
+		}
+
+		firstArc->Set(arc, vertexCount);
+
+		int edge = 0;
+
+		for (int v = 0; v < vertexCount; v++)
+		{
+			auto edgeIter = graph->AdjacentIterator(index->VertexAt(v));
+
+			for (; edgeIter != graph->AdjacentEnd(); ++edgeIter)
+			{
+				int end = index->IndexOf((*edgeIter)->GetEnd());
+
+				int forward = nextArc.Get(v);
+				int backward = nextArc.Get(end);
+
+				nextArc.Set(forward + 1, v);
+				nextArc.Set(backward + 1, end);
+
+				SetArc(forward, end, (*edgeIter)->GetWeight(), backward, true);
+				SetArc(backward, v, 0, forward, false);
+
+				edgeOrder->Set(forward, edge);
+				edge++;
+			}
+		}
+	}
+public:
+	int VertexCount() const
+	{
+		return index->Count();
+	}
+	int ArcCount() const
+	{
+		return arcCount;
+	}
+
+	// Every edge has an arc and a pair
+	int EdgeCount() const
+	{
+		return arcCount / 2;
+	}
+
+	int ArcsBegin(int vertex) const
+	{
+		return firstArc->Get(vertex);
+	}
+	int ArcsEnd(int vertex) const
+	{
+		return firstArc->Get(vertex + 1);
+	}
+	int ArcEnd(int arc) const
+	{
+		return arcEnds->Get(arc);
+	}
+	// Start of the arc is the end of its pair
+	int ArcStart(int arc) const
+	{
+		return arcEnds->Get(pairs->Get(arc));
+	}
+	int Pair(int arc) const
+	{
+		return pairs->Get(arc);
+	}
+	int Capacity(int arc) const
+	{
+		return capacities->Get(arc);
+	}
+	int Flow(int arc) const
+	{
+		return flows->Get(arc);
+	}
+	// How much more flow the arc can take
+	int Residual(int arc) const
+	{
+		return capacities->Get(arc) - flows->Get(arc);
+	}
+
+	bool IsEdge(int arc) const
+	{
+		return edgeArcs->Get(arc);
+	}
+	// Arc of the edge from one vertex to another, -1 if the graph has no such edge
+	int EdgeArc(int startVertex, int endVertex) const
+	{
+		for (int arc = ArcsBegin(startVertex); arc < ArcsEnd(startVertex); arc++)
+			if (edgeArcs->Get(arc) && arcEnds->Get(arc) == endVertex)
+				return arc;
+
+		return -1;
+	}
+
+	// Flow of the arc stays the same, even if it no longer fits
+	void SetCapacity(int arc, int capacity)
+	{
+		capacities->Set(capacity, arc);
+	}
+
+	// Sends more flow along the arc, and the same amount back along its pair
+	void Push(int arc, int amount)
+	{
+		flows->Set(flows->Get(arc) + amount, arc);
+		flows->Set(flows->Get(pairs->Get(arc)) - amount, pairs->Get(arc));
+	}
+
+	// Flow leaving the vertex, negative if more comes in than goes out
+	int Outflow(int vertex) const
+	{
+		int res = 0;
+
+		for (int arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); arc++)
+			res += flows->Get(arc);
+
+		return res;
+	}
+
+	int IndexOf(T vertex) const
+	{
+		return index->IndexOf(vertex);
+	}
+	T VertexAt(int vertex) const
+	{
+		return index->VertexAt(vertex);
+	}
+
+	// Graph with the same vertices, where every edge of the network and the opposite one
+	// are weighted with the flow going that way, negative if it goes the other way
+	Graph<T>* CreateFlowGraph(std::function<int(T, int)> hashFunc) const
+	{
+		Graph<T>* res = new Graph<T>(hashFunc);
+
+		for (int v = 0; v < VertexCount(); v++)
+			res->AddVertex(index->VertexAt(v));
+
+		for (int v = 0; v < VertexCount(); v++)
+		{
+			T start = index->VertexAt(v);
+
+			for (int arc = ArcsBegin(v); arc < ArcsEnd(v); arc++)
+			{
+				T end = index->VertexAt(ArcEnd(arc));
+
+				// Both edges between two vertices add to the same flow
+				int flow = flows->Get(arc);
+
+				if (res->AreConnected(start, end))
+					flow += res->EdgeLength(start, end);
+
+				res->SetAdjacent(start, end, flow);
+			}
+		}
+
+		return res;
+	}
+
+	// Flow through every edge, without building a graph
+	EdgeStreams<T>* CreateEdgeStreams() const
+	{
+		EdgeStreams<T>* res = new EdgeStreams<T>(EdgeCount());
+
+		for (int edge = 0; edge < EdgeCount(); edge++)
+		{
+			int arc = edgeOrder->Get(edge);
+
+			res->Set(edge, index->VertexAt(ArcStart(arc)), index->VertexAt(ArcEnd(arc)), flows->Get(arc));
+		}
+
+		return res;
+	}
+
+	// Cut found by one search from the start vertex over arcs with free capacity.
+	// It is minimal, when no more flow can get from the start to the end
+	MinCut<T>* CreateMinCut(int startVertex) const
+	{
+		MinCut<T>* res = new MinCut<T>();
+
+		DynamicArray<bool> reached(VertexCount() + 1);
+		DynamicArray<int> queue(VertexCount() + 1);
+
+		for (int v = 0; v < VertexCount(); v++)
+			reached.Set(false, v);
+
+		int queueBegin = 0;
+		int queueEnd = 0;
+
+		reached.Set(true, startVertex);
+		queue.Set(startVertex, queueEnd++);
+
+		while (queueBegin < queueEnd)
+		{
+			int tmp = queue.Get(queueBegin++);
+
+			for (int arc = ArcsBegin(tmp); arc < ArcsEnd(tmp); arc++)
+			{
+				int end = ArcEnd(arc);
+
+				if (Residual(arc) > 0 && !reached.Get(end))
+				{
+					reached.Set(true, end);
+					queue.Set(end, queueEnd++);
+				}
+			}
+		}
+
+		// Arcs with no capacity are pairs of edges going the other way
+		for (int i = 0; i < queueEnd; i++)
+		{
+			int v = queue.Get(i);
+
+			res->AddVertex(index->VertexAt(v));
+
+			for (int arc = ArcsBegin(v); arc < ArcsEnd(v); arc++)
+				if (capacities->Get(arc) > 0 && !reached.Get(ArcEnd(arc)))
+					res->AddEdge(index->VertexAt(v), index->VertexAt(ArcEnd(arc)), capacities->Get(arc));
+		}
+
+		return res;
+	}
+private:
+	void SetArc(int arc, int end, int capacity, int pair, bool isEdge)
+	{
+		arcEnds->Set(end, arc);
+		capacities->Set(capacity, arc);
+		flows->Set(0, arc);
+		pairs->Set(pair, arc);
+		edgeArcs->Set(isEdge, arc);
+	}
+public:
+	~ResidualNetwork()
+	{
+		delete(index);
+		delete(firstArc);
+		delete(arcEnds);
+		delete(capacities);
+		delete(flows);
+		delete(pairs);
+		delete(edgeArcs);
+		delete(edgeOrder);
+	}
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "dependencies/HashMap.h"
+
+#include "Graph.h"
+#include "GraphPathfinder.h"
+
+using namespace dictionary;
+
+// Keeps searches from the start vertices asked for most recently, so asking for
+// paths from the same start again continues the search that is already there.
+// When the cache is full, search used the longest time ago is thrown away.
+// Everything is forgotten, as soon as the graph version changes
+template<class T>
+class ShortestPathCache
+{
+public:
+	static const int inf = DijkstraPathfinder<T>::inf;
+private:
+	struct CacheEntry
+	{
+		DijkstraPathfinder<T>* pathfinder;
+		// Value of useCounter, when the entry was used last time
+		int lastUsed;
+	};
+
+	Graph<T>* graph;
+
+	IDictionary<T, CacheEntry>* entries;
+
+	int capacity;
+	QueueType queueType;
+
+	// Graph version all cached searches were made for
+	int graphVersion;
+
+	int useCounter;
+	int hitCount;
+	int missCount;
+
+	static const int default_capacity = 16;
+public:
+	ShortestPathCache(Graph<T>* graph, int capacity = default_capacity, QueueType queueType = QueueType::BINARY_HEAP) :
+		graph(graph), entries(new HashMap<T, CacheEntry>(graph->GetHashFunction())),
+		capacity(capacity), queueType(queueType), graphVersion(graph->Version()),
+		useCounter(0), hitCount(0), missCount(0)
+	{
+		if (capacity < 1)
+			throw std::invalid_argument("Cache must hold at least one search");
+	}
+public:
+	int GetDistance(T startVertex, T endVertex)
+	{
+		return Search(startVertex)->GetDistance(endVertex);
+	}
+
+	Sequence<T>* GetPath(T startVertex, T endVertex)
+	{
+		return Search(startVertex)->GetPath(endVertex);
+	}
+
+	// Search from the start vertex, valid until the graph changes or it is evicted
+	DijkstraPathfinder<T>* Search(T startVertex)
+	{
+		if (graph->Version() != graphVersion)
+		{
+			Clear();
+			graphVersion = graph->Version();
+		}
+
+		useCounter++;
+
+		if (entries->Contains(startVertex))
+		{
+			CacheEntry entry = entries->Get(startVertex);
+
+			entry.lastUsed = useCounter;
+			entries->Add(startVertex, entry);
+
+			hitCount++;
+
+			return entry.pathfinder;
+		}
+
+		if (!graph->HasVertex(startVertex))
+			throw vertex_not_found("No such vertex in the graph");
+
+		missCount++;
+
+		if (entries->Count() >= capacity)
+			EvictLeastRecent();
+
+		CacheEntry entry;
+
+		entry.pathfinder = new DijkstraPathfinder<T>(graph, startVertex, queueType);
+		entry.lastUsed = useCounter;
+
+		entries->Add(startVertex, entry);
+
+		return entry.pathfinder;
+	}
+
+	void Clear()
+	{
+		auto iter = dynamic_cast<HashMap<T, CacheEntry>*>(entries)->Iterator();
+
+		for (; iter != dynamic_cast<HashMap<T, CacheEntry>*>(entries)->End(); ++iter)
+		{
+			delete((*iter).second.pathfinder);
+		}
+
+		delete(entries);
+		entries = new HashMap<T, CacheEntry>(graph->GetHashFunction());
+	}
+
+	int Count() const
+	{
+		return entries->Count();
+	}
+	int Capacity() const
+	{
+		return capacity;
+	}
+	int HitCount() const
+	{
+		return hitCount;
+	}
+	int MissCount() const
+	{
+		return missCount;
+	}
+private:
+	// Goes through all entries, which is cheap next to the search that will take the place
+	void EvictLeastRecent()
+	{
+		auto iter = dynamic_cast<HashMap<T, CacheEntry>*>(entries)->Iterator();
+
+		T oldest = (*iter).first;
+		CacheEntry oldestEntry = (*iter).second;
+
+		for (; iter != dynamic_cast<HashMap<T, CacheEntry>*>(entries)->End(); ++iter)
+		{
+			if ((*iter).second.lastUsed < oldestEntry.lastUsed)
+			{
+				oldest = (*iter).first;
+				oldestEntry = (*iter).second;
+			}
+		}
+
+		delete(oldestEntry.pathfinder);
+		entries->Remove(oldest);
+	}
+public:
+	~ShortestPathCache()
+	{
+		Clear();
+
+		delete(entries);
+	}
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "dependencies/DynamicArray.h"
+#include "dependencies/HashMap.h"
+#include "dependencies/Sequence.h"
+
+#include "Graph.h"
+
+using namespace dictionary;
+
+// Numbers vertices from 0 to Count() - 1, so data about them can be kept in arrays
+template<class T>
+class VertexIndex
+{
+private:
+	IDictionary<T, int>* indices;
+	DynamicArray<T>* vertices;
+
+	int count;
+public:
+	VertexIndex(Graph<T>* graph) :
+		indices(new HashMap<T, int>(graph->GetHashFunction())),
+		vertices(new DynamicArray<T>(graph->VertexCount() + 1)), count(0)
+	{
+		auto iter = graph->begin();
+
+		for (; iter != graph->end(); ++iter)
+		{
+			Add((*iter).first);
+		}
+	}
+
+	VertexIndex(Sequence<T>* vertexSequence, std::function<int(T, int)> hashFunc) :
+		indices(new HashMap<T, int>(hashFunc)),
+		vertices(new DynamicArray<T>(vertexSequence->GetLength() + 1)), count(0)
+	{
+		for (int i = 0; i < vertexSequence->GetLength(); i++)
+		{
+			Add(vertexSequence->Get(i));
+		}
+	}
+public:
+	int Count() const
+	{
+		return count;
+	}
+	int IndexOf(T vertex) const
+	{
+		try {
+			return indices->Get(vertex);
+		}
+		catch (key_not_found e)
+		{
+			throw vertex_not_found("Vertex is not indexed");
+		}
+	}
+	T VertexAt(int index) const
+	{
+		return vertices->Get(index);
+	}
+	bool Contains(T vertex) const
+	{
+		return indices->Contains(vertex);
+	}
+private:
+	void Add(T vertex)
+	{
+		if (indices->Contains(vertex))
+			return;
+
+		indices->Add(vertex, count);
+		vertices->Set(vertex, count);
+		count++;
+	}
+public:
+	~VertexIndex()
+	{
+		delete(indices);
+		delete(vertices);
+	}
+};
@@ -113,6 +113,20 @@ namespace dictionary
 			else
 				return false;
 		}
+		//Removes all items in place, the table keeps its size
+		void Clear()
+		{
+			for (int i = 0; i < GetCapacity() && itemsCount > 0; i++)
+			{
+				LinkedList<KeyValuePair>* target = table->Get(i);
+
+				while (!target->IsEmpty())
+				{
+					target->Remove(0);
+					itemsCount--;
+				}
+			}
+		}
 	public:
 		virtual int GetCapacity() const override
 		{
@@ -166,7 +180,9 @@ namespace dictionary
 		}
 		void Shrink()
 		{
-			if (GetCapacity() > default_size && FillCoefficient() < 0.5)
+			//Lower than half of the grow threshold, so that a map hovering
+			//around the boundary is not resized on every Add/Remove pair
+			if (GetCapacity() > default_size && FillCoefficient() < 0.25)
 				Resize(GetCapacity() / 2);
 		}
 		void Resize(int newSize)